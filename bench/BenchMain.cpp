@@ -0,0 +1,331 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "Benchmark.h"
+#include "CharacterSignature.h"
+#include "CodeSmellDetector.h"
+#include "CorpusGenerator.h"
+#include "Function.h"
+#include "Parser.h"
+#include "ShingleSignature.h"
+#include "StructuralIndex.h"
+#include "Tokenizer.h"
+
+using namespace std;
+
+struct BenchOptions {
+    CorpusOptions corpus;
+    double minimumSeconds = 0.5;
+    string filter;
+    string generateDirectory; // Write the corpus here instead of running the benchmarks
+    size_t fileCount = 1;
+};
+
+// One generated file, split into lines the way SourceFile splits a mapped file
+struct Corpus {
+    string contents;
+    vector<string_view> lines;
+};
+
+void printUsage(const string &programName);
+bool parseArguments(int argc, char *argv[], BenchOptions &options);
+bool parseCount(const string &text, size_t &count);
+Corpus makeCorpus(const CorpusGenerator &generator, size_t fileIndex);
+int generateCorpus(const CorpusGenerator &generator, const BenchOptions &options);
+void runMicroBenchmarks(Benchmark &benchmark, const Corpus &corpus);
+void runDetectorBenchmarks(Benchmark &benchmark, const Corpus &corpus);
+
+int main(int argc, char *argv[]) {
+    BenchOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    unique_ptr<CorpusGenerator> generator;
+    try {
+        generator.reset(new CorpusGenerator(options.corpus));
+    } catch (const std::exception &e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!options.generateDirectory.empty()) {
+        return generateCorpus(*generator, options);
+    }
+
+    Corpus corpus = makeCorpus(*generator, 0);
+    cout << "Corpus: " << options.corpus.functionCount << " functions, " << corpus.lines.size() << " lines, "
+         << corpus.contents.size() << " bytes, duplication rate " << options.corpus.duplicationRate
+         << ", seed " << options.corpus.seed << endl;
+    cout << "Kernels: popcount " << CharacterSignature::kernelName() << ", structural index "
+         << StructuralIndex::kernelName() << endl;
+
+    Benchmark benchmark(options.minimumSeconds, options.filter);
+    runMicroBenchmarks(benchmark, corpus);
+    runDetectorBenchmarks(benchmark, corpus);
+
+    cout << "Checksum: " << hex << benchmark.getChecksum() << dec << endl;
+    return 0;
+}
+
+void printUsage(const string &programName) {
+    cerr << "usage: " << programName << " [OPTIONS]" << endl;
+    cerr << endl;
+    cerr << "options:" << endl;
+    cerr << "  --functions N         functions per generated file (default: 1000)" << endl;
+    cerr << "  --lines MIN MAX       statements per function body (default: 3 30)" << endl;
+    cerr << "  --parameters MIN MAX  parameters per function (default: 0 6)" << endl;
+    cerr << "  --duplication RATE    share of functions that are edited copies, 0 to 1 (default: 0.1)" << endl;
+    cerr << "  --seed N              corpus seed (default: 1)" << endl;
+    cerr << "  --time SECONDS        minimum time spent on each benchmark (default: 0.5)" << endl;
+    cerr << "  --filter TEXT         only run benchmarks whose name contains TEXT" << endl;
+    cerr << "  --generate DIR        write the corpus to DIR instead of running the benchmarks" << endl;
+    cerr << "  --files N             number of files to write with --generate (default: 1)" << endl;
+}
+
+bool parseArguments(int argc, char *argv[], BenchOptions &options) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool hasTwoValues = i + 2 < argc;
+
+        try {
+            if (arg == "--functions") {
+                if (!hasValue || !parseCount(argv[++i], options.corpus.functionCount)) {
+                    return false;
+                }
+            } else if (arg == "--lines") {
+                if (!hasTwoValues || !parseCount(argv[++i], options.corpus.minLines) ||
+                    !parseCount(argv[++i], options.corpus.maxLines)) {
+                    return false;
+                }
+            } else if (arg == "--parameters") {
+                if (!hasTwoValues || !parseCount(argv[++i], options.corpus.minParameters) ||
+                    !parseCount(argv[++i], options.corpus.maxParameters)) {
+                    return false;
+                }
+            } else if (arg == "--duplication" && hasValue) {
+                options.corpus.duplicationRate = stod(argv[++i]);
+            } else if (arg == "--seed" && hasValue) {
+                options.corpus.seed = stoull(argv[++i]);
+            } else if (arg == "--time" && hasValue) {
+                options.minimumSeconds = stod(argv[++i]);
+            } else if (arg == "--filter" && hasValue) {
+                options.filter = argv[++i];
+            } else if (arg == "--generate" && hasValue) {
+                options.generateDirectory = argv[++i];
+            } else if (arg == "--files") {
+                if (!hasValue || !parseCount(argv[++i], options.fileCount)) {
+                    return false;
+                }
+            } else {
+                cerr << "unknown option: " << arg << endl;
+                return false;
+            }
+        } catch (const exception &e) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool parseCount(const string &text, size_t &count) {
+    if (text.empty() || text.find_first_not_of("0123456789") != string::npos) {
+        return false;
+    }
+
+    try {
+        count = stoul(text);
+    } catch (const exception &e) {
+        return false;
+    }
+    return true;
+}
+
+Corpus makeCorpus(const CorpusGenerator &generator, size_t fileIndex) {
+    Corpus corpus;
+    corpus.contents = generator.generateFile(fileIndex);
+
+    string_view contents = corpus.contents;
+    size_t lineStart = 0;
+    while (lineStart < contents.size()) {
+        size_t lineEnd = contents.find('\n', lineStart);
+        if (lineEnd == string_view::npos) {
+            lineEnd = contents.size();
+        }
+        corpus.lines.push_back(contents.substr(lineStart, lineEnd - lineStart));
+        lineStart = lineEnd + 1;
+    }
+    return corpus;
+}
+
+int generateCorpus(const CorpusGenerator &generator, const BenchOptions &options) {
+    for (size_t i = 0; i < options.fileCount; i++) {
+        string filename = options.generateDirectory + "/corpus_" + to_string(i) + ".cpp";
+        ofstream file(filename, ios::binary | ios::trunc);
+        string contents = generator.generateFile(i);
+        file.write(contents.data(), static_cast<streamsize>(contents.size()));
+        if (!file) {
+            cerr << "error writing file: [" << filename << "]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    cout << "Wrote " << options.fileCount << " file(s) to " << options.generateDirectory << endl;
+    return 0;
+}
+
+void runMicroBenchmarks(Benchmark &benchmark, const Corpus &corpus) {
+    size_t corpusBytes = corpus.contents.size();
+
+    benchmark.run("parser/extract", [&corpus, corpusBytes]() {
+        pmr::monotonic_buffer_resource arena;
+        Parser parser(corpus.lines);
+        Benchmark::Workload workload;
+        workload.bytes = corpusBytes;
+        parser.forEachFunction([&](size_t firstLineNumber, size_t lastLineNumber) {
+            workload.checksum += parser.getFunctionContent(firstLineNumber, lastLineNumber, &arena).size();
+            workload.functions++;
+        });
+        return workload;
+    });
+
+    // Every call site and parameter list in the file, from its opening parenthesis to the end of the line
+    vector<string_view> bracketRuns;
+    size_t bracketBytes = 0;
+    for (string_view line : corpus.lines) {
+        for (size_t open = line.find('('); open != string_view::npos; open = line.find('(', open + 1)) {
+            bracketRuns.push_back(line.substr(open));
+            bracketBytes += line.size() - open;
+        }
+    }
+
+    benchmark.run("parser/closing-bracket", [&bracketRuns, bracketBytes]() {
+        Benchmark::Workload workload;
+        workload.bytes = bracketBytes;
+        for (string_view run : bracketRuns) {
+            workload.checksum += Parser::getClosingBracketIndex(run, Parser::OPENING_PAREN);
+        }
+        return workload;
+    });
+
+    // The remaining benchmarks work on the extracted functions, set up once
+    pmr::monotonic_buffer_resource arena;
+    vector<Span<string_view>> contents;
+    vector<pair<size_t, size_t>> lineRanges;
+    Parser parser(corpus.lines);
+    parser.forEachFunction([&](size_t firstLineNumber, size_t lastLineNumber) {
+        contents.push_back(parser.getFunctionContent(firstLineNumber, lastLineNumber, &arena));
+        lineRanges.emplace_back(firstLineNumber, lastLineNumber);
+    });
+
+    benchmark.run("function/construct", [&contents, &lineRanges]() {
+        Benchmark::Workload workload;
+        for (size_t i = 0; i < contents.size(); i++) {
+            Function function(contents[i], lineRanges[i].first, lineRanges[i].second);
+            workload.checksum += function.getNumberOfLinesOfCode() + function.getNumberOfParameters() +
+                                 function.computeCharacterSignature().count();
+            for (string_view line : contents[i]) {
+                workload.bytes += line.size();
+            }
+        }
+        workload.functions = contents.size();
+        return workload;
+    });
+
+    size_t pairCount = contents.size() * (contents.size() - min<size_t>(contents.size(), 1)) / 2;
+
+    if (benchmark.selected("jaccard/character")) {
+        vector<CharacterSignature> signatures;
+        for (size_t i = 0; i < contents.size(); i++) {
+            signatures.push_back(Function(contents[i], lineRanges[i].first, lineRanges[i].second)
+                                         .computeCharacterSignature());
+        }
+
+        benchmark.run("jaccard/character", [&signatures, pairCount]() {
+            Benchmark::Workload workload;
+            workload.pairs = pairCount;
+            for (size_t i = 0; i < signatures.size(); i++) {
+                for (size_t j = i + 1; j < signatures.size(); j++) {
+                    double similarity = CodeSmellDetector::jaccardSimilarityIndex(signatures[i], signatures[j]);
+                    workload.checksum += CodeSmellDetector::isDuplicatedCode(similarity);
+                }
+            }
+            return workload;
+        });
+    }
+
+    if (benchmark.selected("jaccard/shingle")) {
+        vector<ShingleSignature> signatures;
+        vector<uint32_t> tokens;
+        vector<uint32_t> tokenLines;
+        for (pair<size_t, size_t> lineRange : lineRanges) {
+            tokens.clear();
+            tokenLines.clear();
+            Tokenizer::lexTokens(parser.getFunctionSource(lineRange.first, lineRange.second), tokens, tokenLines);
+            signatures.emplace_back(tokens, DetectorConfig().shingleSize, false);
+        }
+
+        benchmark.run("jaccard/shingle", [&signatures, pairCount]() {
+            Benchmark::Workload workload;
+            workload.pairs = pairCount;
+            for (size_t i = 0; i < signatures.size(); i++) {
+                for (size_t j = i + 1; j < signatures.size(); j++) {
+                    double similarity = CodeSmellDetector::jaccardSimilarityIndex(signatures[i].getShingles(),
+                                                                                  signatures[j].getShingles());
+                    workload.checksum += CodeSmellDetector::isDuplicatedCode(similarity);
+                }
+            }
+            return workload;
+        });
+    }
+}
+
+void runDetectorBenchmarks(Benchmark &benchmark, const Corpus &corpus) {
+    struct DetectorCase {
+        const char *name;
+        DetectorConfig::SimilarityMetric similarityMetric;
+        DetectorConfig::DuplicateSearch duplicateSearch;
+        size_t pairScanThreadCount;
+        bool pruneCandidatePairs;
+    };
+
+    const DetectorCase cases[] = {
+            {"detector/char-exact",             DetectorConfig::CHARACTER,     DetectorConfig::EXACT, 1, true},
+            {"detector/char-exact-unfiltered",  DetectorConfig::CHARACTER,     DetectorConfig::EXACT, 1, false},
+            {"detector/char-exact-threads",     DetectorConfig::CHARACTER,     DetectorConfig::EXACT, 0, true},
+            {"detector/char-lsh",               DetectorConfig::CHARACTER,     DetectorConfig::LSH,   1, true},
+            {"detector/token-exact",            DetectorConfig::TOKEN_SHINGLE, DetectorConfig::EXACT, 1, true},
+            {"detector/token-exact-unfiltered", DetectorConfig::TOKEN_SHINGLE, DetectorConfig::EXACT, 1, false},
+            {"detector/token-exact-threads",    DetectorConfig::TOKEN_SHINGLE, DetectorConfig::EXACT, 0, true},
+            {"detector/token-lsh",              DetectorConfig::TOKEN_SHINGLE, DetectorConfig::LSH,   1, true}
+    };
+
+    for (const DetectorCase &detectorCase : cases) {
+        DetectorConfig config;
+        config.similarityMetric = detectorCase.similarityMetric;
+        config.duplicateSearch = detectorCase.duplicateSearch;
+        config.pairScanThreadCount = detectorCase.pairScanThreadCount;
+        config.pruneCandidatePairs = detectorCase.pruneCandidatePairs;
+
+        // End to end, from the lines of the file to the finished occurrence lists
+        benchmark.run(detectorCase.name, [&corpus, config]() {
+            CodeSmellDetector detector(corpus.lines, config);
+            Benchmark::Workload workload;
+            workload.bytes = corpus.contents.size();
+            workload.functions = detector.getFunctions().size();
+            workload.pairs = detector.getComparedPairCount();
+            workload.checksum = detector.viewDuplicateCodeOccurrences().size();
+            return workload;
+        });
+    }
+}
@@ -0,0 +1,65 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "Benchmark.h"
+#include "Hash.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+Benchmark::Benchmark(double minimumSeconds, const string &filter) {
+    this->minimumSeconds = minimumSeconds;
+    this->filter = filter;
+    this->checksum = 0;
+}
+
+void Benchmark::run(const string &name, const Body &body) {
+    if (!selected(name)) {
+        return;
+    }
+
+    Workload total;
+    size_t iterations = 0;
+    double seconds = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    do {
+        Workload workload = body();
+        total.bytes += workload.bytes;
+        total.functions += workload.functions;
+        total.pairs += workload.pairs;
+        if (iterations == 0) {
+            checksum = Hash::combine(checksum, workload.checksum);
+        }
+        iterations++;
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    } while (seconds < minimumSeconds);
+
+    cout << left << setw(32) << name << right << setw(8) << iterations << " iterations "
+         << setw(12) << setprecision(3) << fixed << seconds * 1e3 / static_cast<double>(iterations) << " ms/iter";
+    if (total.bytes > 0) {
+        printRate(static_cast<double>(total.bytes) / 1e6, seconds, "MB/s");
+    }
+    if (total.functions > 0) {
+        printRate(static_cast<double>(total.functions), seconds, "functions/s");
+    }
+    if (total.pairs > 0) {
+        printRate(static_cast<double>(total.pairs), seconds, "pairs/s");
+    }
+    cout << endl;
+}
+
+bool Benchmark::selected(const string &name) const {
+    return filter.empty() || name.find(filter) != string::npos;
+}
+
+uint64_t Benchmark::getChecksum() const {
+    return checksum;
+}
+
+void Benchmark::printRate(double amount, double seconds, const char *unit) {
+    cout << setw(14) << setprecision(2) << fixed << amount / seconds << " " << unit;
+}
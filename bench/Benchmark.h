@@ -0,0 +1,68 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_BENCHMARK_H
+#define CODESMELLDETECTOR_BENCHMARK_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+using namespace std;
+
+/**
+ * Minimal timing harness. Each benchmark body runs back to back until a minimum amount of
+ * time has passed, then the throughput over all iterations is printed: MB/s for the bytes,
+ * functions/s and pairs/s for the items the body reports it processed.
+ */
+class Benchmark {
+public:
+    // What one call of a benchmark body got through; zero counts are not reported
+    struct Workload {
+        size_t bytes = 0;
+        size_t functions = 0;
+        size_t pairs = 0;
+        uint64_t checksum = 0; // Folded into a total that is printed, so the work cannot be optimized away
+    };
+
+    typedef function<Workload()> Body;
+
+    /**
+     * Initialize the harness
+     * @param minimumSeconds how long to keep repeating each body
+     * @param filter only run benchmarks whose name contains this, empty runs all of them
+     */
+    Benchmark(double minimumSeconds, const string &filter);
+
+    /**
+     * Time a body and print its throughput, unless the filter skips it
+     * @param name benchmark name, "group/case"
+     * @param body work to repeat
+     */
+    void run(const string &name, const Body &body);
+
+    /**
+     * Does the filter select this benchmark? Lets callers skip expensive setup.
+     * @param name benchmark name
+     * @return true if it would run, false if not
+     */
+    bool selected(const string &name) const;
+
+    /**
+     * Get the combined checksum of the benchmarks run so far. It only depends on the results,
+     * not on the number of iterations, so the same corpus gives the same checksum on every run.
+     * @return checksum
+     */
+    uint64_t getChecksum() const;
+
+private:
+    double minimumSeconds;
+    string filter;
+    uint64_t checksum;
+
+    static void printRate(double amount, double seconds, const char *unit);
+};
+
+
+#endif //CODESMELLDETECTOR_BENCHMARK_H
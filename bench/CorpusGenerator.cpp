@@ -0,0 +1,200 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "CorpusGenerator.h"
+#include "Hash.h"
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+    const char *TYPES[] = {"int", "double", "size_t", "const string &", "const vector<int> &", "bool"};
+    const char *SYLLABLES[] = {"count", "total", "index", "value", "node", "buffer", "offset", "limit",
+                               "item", "result", "width", "score", "name", "depth", "entry", "step"};
+    const char *VERBS[] = {"compute", "update", "find", "parse", "merge", "collect", "resolve", "apply"};
+    const char *COMMENTS[] = {"// Skip the entries that were already handled",
+                              "// Keep the running total in range",
+                              "/* Fall back to the slow path */",
+                              "// TODO: cache this"};
+
+    template<typename T, size_t N>
+    const T &pick(const T (&items)[N], uint64_t random) {
+        return items[random % N];
+    }
+}
+
+CorpusGenerator::Random::Random(uint64_t seed) {
+    this->state = seed;
+}
+
+uint64_t CorpusGenerator::Random::next() {
+    state += 0x9e3779b97f4a7c15ULL;
+    return Hash::mix(state);
+}
+
+size_t CorpusGenerator::Random::between(size_t low, size_t high) {
+    return low + static_cast<size_t>(next() % (high - low + 1));
+}
+
+bool CorpusGenerator::Random::chance(double probability) {
+    // 53 random bits give a uniform double in [0, 1)
+    return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0) < probability;
+}
+
+CorpusGenerator::CorpusGenerator(const CorpusOptions &options) {
+    if (options.minLines == 0 || options.minLines > options.maxLines ||
+        options.minParameters > options.maxParameters) {
+        throw invalid_argument("corpus ranges must not be empty");
+    }
+    if (!(options.duplicationRate >= 0 && options.duplicationRate <= 1)) {
+        throw invalid_argument("duplication rate must be between 0 and 1");
+    }
+    this->options = options;
+}
+
+string CorpusGenerator::generateFile(size_t fileIndex) const {
+    Random random(Hash::combine(options.seed, fileIndex));
+    string file = "#include <string>\n#include <vector>\n\nusing namespace std;\n\n";
+
+    vector<vector<string>> bodies;
+    vector<vector<string>> parameterLists;
+    bodies.reserve(options.functionCount);
+    parameterLists.reserve(options.functionCount);
+
+    for (size_t i = 0; i < options.functionCount; i++) {
+        string name = string(pick(VERBS, random.next())) + "_" + pick(SYLLABLES, random.next()) +
+                      to_string(fileIndex) + "_" + to_string(i);
+
+        // A copy keeps the original's parameters, the way pasted code usually does
+        if (!bodies.empty() && random.chance(options.duplicationRate)) {
+            size_t original = random.between(0, bodies.size() - 1);
+            parameterLists.push_back(parameterLists[original]);
+            bodies.push_back(mutateBody(random, bodies[original]));
+        } else {
+            vector<string> parameters;
+            size_t parameterCount = random.between(options.minParameters, options.maxParameters);
+            for (size_t p = 0; p < parameterCount; p++) {
+                parameters.push_back(string(pick(TYPES, random.next())) + " " + pick(SYLLABLES, random.next()) +
+                                     to_string(p));
+            }
+            parameterLists.push_back(parameters);
+            bodies.push_back(generateBody(random, parameters));
+        }
+
+        if (random.chance(0.05)) {
+            file += "int " + name + "(int value);\n\n"; // A forward declaration, not a definition
+        }
+        if (random.chance(0.2)) {
+            file += string(pick(COMMENTS, random.next())) + "\n";
+        }
+        appendFunction(file, name, parameterLists.back(), bodies.back());
+    }
+
+    return file;
+}
+
+vector<string> CorpusGenerator::generateBody(Random &random, const vector<string> &parameterNames) const {
+    vector<string> names;
+    for (const string &parameter : parameterNames) {
+        names.push_back(parameter.substr(parameter.rfind(' ') + 1));
+    }
+    names.push_back("total");
+
+    vector<string> body = {"int total = 0;"};
+    size_t statementCount = random.between(options.minLines, options.maxLines);
+    size_t depth = 0;
+
+    while (body.size() < statementCount) {
+        uint64_t kind = random.next() % 10;
+        if (kind == 0 && depth < 3 && body.size() + 2 < statementCount) {
+            string counter = "i" + to_string(depth);
+            body.push_back("for (int " + counter + " = 0; " + counter + " < " + pickName(random, names) +
+                           "; " + counter + "++) {");
+            names.push_back(counter);
+            depth++;
+        } else if (kind == 1 && depth > 0) {
+            body.push_back("}");
+            names.pop_back();
+            depth--;
+        } else if (kind == 2) {
+            body.push_back(pick(COMMENTS, random.next()));
+        } else if (kind == 3) {
+            body.push_back("");
+        } else {
+            body.push_back(generateStatement(random, names, depth));
+        }
+    }
+
+    for (; depth > 0; depth--) {
+        body.push_back("}");
+    }
+    body.push_back("return total;");
+    return body;
+}
+
+vector<string> CorpusGenerator::mutateBody(Random &random, vector<string> body) {
+    size_t editCount = random.between(1, 3);
+    for (size_t i = 0; i < editCount; i++) {
+        string &line = body[random.between(0, body.size() - 1)];
+        size_t digit = line.find_first_of("0123456789");
+        if (digit != string::npos) {
+            line[digit] = static_cast<char>('0' + random.next() % 10);
+        } else if (!line.empty() && line.back() == ';') {
+            line.insert(line.size() - 1, " + 1");
+        }
+    }
+    return body;
+}
+
+string CorpusGenerator::generateStatement(Random &random, const vector<string> &names, size_t depth) {
+    string first = pickName(random, names);
+    string second = pickName(random, names);
+    string constant = to_string(random.between(0, 999));
+
+    switch (random.next() % 6) {
+        case 0:
+            return "auto " + string(pick(SYLLABLES, random.next())) + to_string(depth) + to_string(random.next() % 100) +
+                   " = " + first + " * " + constant + ";";
+        case 1:
+            return "total += " + first + " % (" + second + " + " + constant + ");";
+        case 2:
+            return "if (" + first + " > " + constant + ") { total -= " + second + "; }";
+        case 3:
+            return "log(\"" + first + " {\" + to_string(" + second + ") + \"}\");";
+        case 4:
+            return "total = max(total, helper(" + first + ", " + second + ", '{'));";
+        default:
+            return "while (" + first + " < " + constant + " && total != 0) { total /= 2; }";
+    }
+}
+
+string CorpusGenerator::pickName(Random &random, const vector<string> &names) {
+    return names[random.next() % names.size()];
+}
+
+void CorpusGenerator::appendFunction(string &file, const string &name, const vector<string> &parameterNames,
+                                     const vector<string> &body) {
+    file += "int " + name + "(";
+    for (size_t i = 0; i < parameterNames.size(); i++) {
+        file += (i == 0 ? "" : ", ") + parameterNames[i];
+    }
+    file += ") {\n";
+
+    size_t depth = 1;
+    for (const string &line : body) {
+        if (line == "}") {
+            depth--;
+        }
+        if (!line.empty()) {
+            file.append(depth * 4, ' ');
+            file += line;
+        }
+        file += '\n';
+        if (!line.empty() && line.back() == '{') {
+            depth++;
+        }
+    }
+
+    file += "}\n\n";
+}
@@ -0,0 +1,79 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_CORPUSGENERATOR_H
+#define CODESMELLDETECTOR_CORPUSGENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Settings for the synthetic source files. Line and parameter counts are drawn uniformly
+ * from the inclusive ranges.
+ */
+struct CorpusOptions {
+    size_t functionCount = 1000;   // Functions per file
+    size_t minLines = 3;           // Statements per function body
+    size_t maxLines = 30;
+    size_t minParameters = 0;
+    size_t maxParameters = 6;
+    double duplicationRate = 0.1;  // Share of functions that are lightly edited copies of an earlier one
+    uint64_t seed = 1;
+};
+
+/**
+ * Writes plausible looking C++ source files for the benchmarks. The same options and file
+ * index always give byte for byte the same file, on every platform: the random numbers come
+ * from a splitmix64 sequence and no standard library distribution is involved. Files have
+ * comments, blank lines, string literals with brackets in them and forward declarations, so
+ * the parser does the same kind of work it does on real code.
+ */
+class CorpusGenerator {
+public:
+    /**
+     * Initialize the generator
+     * @param options shape of the files to generate
+     * @throws invalid_argument if a range is empty or the duplication rate is not in [0, 1]
+     */
+    explicit CorpusGenerator(const CorpusOptions &options);
+
+    /**
+     * Generate one file
+     * @param fileIndex which file of the corpus, each index gives a different file
+     * @return contents of the file
+     */
+    string generateFile(size_t fileIndex) const;
+
+private:
+    // Deterministic random numbers, independent of the standard library
+    class Random {
+    public:
+        explicit Random(uint64_t seed);
+        uint64_t next();
+        size_t between(size_t low, size_t high); // Inclusive
+        bool chance(double probability);
+
+    private:
+        uint64_t state;
+    };
+
+    CorpusOptions options;
+
+    // A function body, one statement per entry, before any indentation
+    vector<string> generateBody(Random &random, const vector<string> &parameterNames) const;
+
+    // Copy a body with a few identifiers and constants changed, like a copy and paste job
+    static vector<string> mutateBody(Random &random, vector<string> body);
+
+    static string generateStatement(Random &random, const vector<string> &names, size_t depth);
+    static string pickName(Random &random, const vector<string> &names);
+    static void appendFunction(string &file, const string &name, const vector<string> &parameterNames,
+                               const vector<string> &body);
+};
+
+
+#endif //CODESMELLDETECTOR_CORPUSGENERATOR_H
@@ -0,0 +1,295 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "AnalysisCache.h"
+#include "CodeSmellDetector.h"
+#include "Hash.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+const char AnalysisCache::MAGIC[8] = {'C', 'S', 'D', 'C', 'A', 'C', 'H', 'E'};
+
+namespace {
+    void appendWord(string &entry, uint64_t value) {
+        entry.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    // Reads words back in order; any read past the end of the entry clears ok
+    struct EntryReader {
+        const string &entry;
+        size_t position = 0;
+        bool ok = true;
+
+        explicit EntryReader(const string &entry) : entry(entry) {}
+
+        uint64_t word() {
+            uint64_t value = 0;
+            if (position + sizeof(value) > entry.size()) {
+                ok = false;
+                return 0;
+            }
+            memcpy(&value, entry.data() + position, sizeof(value));
+            position += sizeof(value);
+            return value;
+        }
+
+        // A count of items that each take at least itemSize more bytes, checked against
+        // what is left so a corrupt count cannot cause a huge allocation
+        size_t count(size_t itemSize) {
+            uint64_t value = word();
+            if (ok && value > (entry.size() - position) / itemSize) {
+                ok = false;
+            }
+            return ok ? value : 0;
+        }
+
+        string text() {
+            size_t length = count(1);
+            string value = entry.substr(position, length);
+            position += length;
+            return value;
+        }
+    };
+}
+
+AnalysisCache::AnalysisCache(const string &directory, const DetectorConfig &config) {
+    this->directory = directory;
+    this->configurationHash = Hash::combine(CodeSmellDetector::configurationHash(config), FORMAT_VERSION);
+    makeDirectories(directory);
+}
+
+bool AnalysisCache::load(string_view contents, AnalysisSummary &summary) {
+    uint64_t contentHash = Hash::bytes(contents);
+
+    ifstream entryFile(entryPath(contentHash), ios::binary);
+    string entry((istreambuf_iterator<char>(entryFile)), istreambuf_iterator<char>());
+
+    if (!entryFile.is_open() || !deserialize(entry, contentHash, contents.size(), summary)) {
+        missCount++;
+        return false;
+    }
+
+    hitCount++;
+    return true;
+}
+
+void AnalysisCache::store(string_view contents, const AnalysisSummary &summary) {
+    uint64_t contentHash = Hash::bytes(contents);
+    string path = entryPath(contentHash);
+    string temporaryPath = path + ".tmp." + to_string(getpid()) + "." + to_string(temporaryFileCount++);
+
+    string entry = serialize(contentHash, contents.size(), summary);
+    {
+        ofstream entryFile(temporaryPath, ios::binary | ios::trunc);
+        entryFile.write(entry.data(), static_cast<streamsize>(entry.size()));
+        if (!entryFile) {
+            entryFile.close();
+            remove(temporaryPath.c_str());
+            return;
+        }
+    }
+
+    if (rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        remove(temporaryPath.c_str());
+    }
+}
+
+size_t AnalysisCache::getHitCount() const {
+    return hitCount;
+}
+
+size_t AnalysisCache::getMissCount() const {
+    return missCount;
+}
+
+string AnalysisCache::entryPath(uint64_t contentHash) const {
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx",
+             static_cast<unsigned long long>(Hash::combine(configurationHash, contentHash)));
+    return directory + "/" + name;
+}
+
+string AnalysisCache::serialize(uint64_t contentHash, size_t contentSize, const AnalysisSummary &summary) const {
+    string entry(MAGIC, sizeof(MAGIC));
+    appendWord(entry, configurationHash);
+    appendWord(entry, contentHash);
+    appendWord(entry, contentSize);
+
+    appendWord(entry, summary.getFunctions().size());
+    for (const AnalysisSummary::FunctionMetrics &function : summary.getFunctions()) {
+        appendWord(entry, function.name.size());
+        entry += function.name;
+        appendWord(entry, function.firstLineNumber);
+        appendWord(entry, function.lastLineNumber);
+        appendWord(entry, function.lineCount);
+        appendWord(entry, static_cast<uint64_t>(static_cast<int64_t>(function.parameterCount)));
+        const uint64_t *words = function.characterSignature.getWords();
+        for (size_t i = 0; i < CharacterSignature::WORD_COUNT; i++) {
+            appendWord(entry, words[i]);
+        }
+        appendWord(entry, function.shingles.size());
+        for (uint64_t shingle : function.shingles) {
+            appendWord(entry, shingle);
+        }
+    }
+
+    appendWord(entry, summary.getLongMethodFunctions().size());
+    for (uint32_t index : summary.getLongMethodFunctions()) {
+        appendWord(entry, index);
+    }
+
+    appendWord(entry, summary.getLongParameterListFunctions().size());
+    for (uint32_t index : summary.getLongParameterListFunctions()) {
+        appendWord(entry, index);
+    }
+
+    appendWord(entry, summary.getDuplicatePairs().size());
+    for (const AnalysisSummary::DuplicatePair &pair : summary.getDuplicatePairs()) {
+        uint64_t similarityBits;
+        memcpy(&similarityBits, &pair.similarityIndex, sizeof(similarityBits));
+        appendWord(entry, pair.firstFunction);
+        appendWord(entry, pair.secondFunction);
+        appendWord(entry, similarityBits);
+    }
+
+    appendWord(entry, summary.getCloneGroups().size());
+    for (const vector<uint32_t> &group : summary.getCloneGroups()) {
+        appendWord(entry, group.size());
+        for (uint32_t index : group) {
+            appendWord(entry, index);
+        }
+    }
+
+    appendWord(entry, summary.getCloneRegions().size());
+    for (const CodeSmellDetector::CloneRegion &region : summary.getCloneRegions()) {
+        appendWord(entry, region.tokenCount);
+        appendWord(entry, region.locations.size());
+        for (const CodeSmellDetector::RegionLocation &location : region.locations) {
+            appendWord(entry, location.functionIndex);
+            appendWord(entry, location.firstLineNumber);
+            appendWord(entry, location.lastLineNumber);
+        }
+    }
+
+    appendWord(entry, summary.getComparedPairCount());
+    appendWord(entry, summary.getOmittedDuplicateCount());
+
+    return entry;
+}
+
+bool AnalysisCache::deserialize(const string &entry, uint64_t contentHash, size_t contentSize,
+                                AnalysisSummary &summary) const {
+    if (entry.size() < sizeof(MAGIC) || entry.compare(0, sizeof(MAGIC), MAGIC, sizeof(MAGIC)) != 0) {
+        return false;
+    }
+
+    EntryReader reader(entry);
+    reader.position = sizeof(MAGIC);
+    if (reader.word() != configurationHash || reader.word() != contentHash || reader.word() != contentSize) {
+        return false;
+    }
+
+    const size_t wordSize = sizeof(uint64_t);
+    vector<AnalysisSummary::FunctionMetrics> functions(reader.count(wordSize * (6 + CharacterSignature::WORD_COUNT)));
+    for (AnalysisSummary::FunctionMetrics &function : functions) {
+        function.name = reader.text();
+        function.firstLineNumber = reader.word();
+        function.lastLineNumber = reader.word();
+        function.lineCount = reader.word();
+        function.parameterCount = static_cast<int>(static_cast<int64_t>(reader.word()));
+        uint64_t words[CharacterSignature::WORD_COUNT];
+        for (uint64_t &word : words) {
+            word = reader.word();
+        }
+        function.characterSignature = CharacterSignature::fromWords(words);
+        function.shingles.resize(reader.count(wordSize));
+        for (uint64_t &shingle : function.shingles) {
+            shingle = reader.word();
+        }
+    }
+
+    // Function indexes are checked too, the summary's getters rely on them
+    bool indexesValid = true;
+    auto readIndex = [&reader, &functions, &indexesValid]() {
+        uint64_t index = reader.word();
+        indexesValid = indexesValid && index < functions.size();
+        return static_cast<uint32_t>(index);
+    };
+
+    vector<uint32_t> longMethodFunctions(reader.count(wordSize));
+    for (uint32_t &index : longMethodFunctions) {
+        index = readIndex();
+    }
+
+    vector<uint32_t> longParameterListFunctions(reader.count(wordSize));
+    for (uint32_t &index : longParameterListFunctions) {
+        index = readIndex();
+    }
+
+    vector<AnalysisSummary::DuplicatePair> duplicatePairs(reader.count(wordSize * 3));
+    for (AnalysisSummary::DuplicatePair &pair : duplicatePairs) {
+        pair.firstFunction = readIndex();
+        pair.secondFunction = readIndex();
+        uint64_t similarityBits = reader.word();
+        memcpy(&pair.similarityIndex, &similarityBits, sizeof(pair.similarityIndex));
+    }
+
+    vector<vector<uint32_t>> cloneGroups(reader.count(wordSize));
+    for (vector<uint32_t> &group : cloneGroups) {
+        group.resize(reader.count(wordSize));
+        for (uint32_t &index : group) {
+            index = readIndex();
+        }
+    }
+
+    vector<CodeSmellDetector::CloneRegion> cloneRegions;
+    size_t cloneRegionCount = reader.count(wordSize * 2);
+    for (size_t i = 0; i < cloneRegionCount; i++) {
+        size_t tokenCount = reader.word();
+        vector<CodeSmellDetector::RegionLocation> locations(reader.count(wordSize * 3));
+        for (CodeSmellDetector::RegionLocation &location : locations) {
+            location.functionIndex = readIndex();
+            location.firstLineNumber = reader.word();
+            location.lastLineNumber = reader.word();
+        }
+        cloneRegions.emplace_back(CodeSmellDetector::DUPLICATED_CODE, tokenCount, move(locations));
+    }
+
+    size_t comparedPairCount = reader.word();
+    size_t omittedDuplicateCount = reader.word();
+
+    if (!reader.ok || !indexesValid || reader.position != entry.size()) {
+        return false;
+    }
+
+    summary = AnalysisSummary(move(functions), move(longMethodFunctions),
+                              move(longParameterListFunctions), move(duplicatePairs), move(cloneGroups),
+                              move(cloneRegions), comparedPairCount, omittedDuplicateCount);
+    return true;
+}
+
+void AnalysisCache::makeDirectories(const string &path) {
+    size_t separator = 0;
+    while (separator != string::npos) {
+        separator = path.find('/', separator + 1);
+        string prefix = path.substr(0, separator);
+
+        if (mkdir(prefix.c_str(), 0777) != 0 && errno != EEXIST) {
+            throw invalid_argument("cannot create cache directory: [" + path + "]");
+        }
+    }
+
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+        throw invalid_argument("cache path is not a directory: [" + path + "]");
+    }
+}
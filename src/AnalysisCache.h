@@ -0,0 +1,87 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_ANALYSISCACHE_H
+#define CODESMELLDETECTOR_ANALYSISCACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "AnalysisSummary.h"
+#include "DetectorConfig.h"
+
+using namespace std;
+
+/**
+ * On-disk cache of analysis results, so unchanged files are not parsed again on the next
+ * run. There is one entry file per distinct file contents, named after a hash of the
+ * contents combined with CodeSmellDetector::configurationHash(), so changing the settings,
+ * the thresholds or the detection logic simply stops old entries from matching. Entries are
+ * written to a temporary file and renamed into place, so concurrent workers (or runs) never
+ * see a partial entry. Unreadable or mismatched entries count as misses. Safe to use from
+ * several threads at once.
+ */
+class AnalysisCache {
+public:
+    /**
+     * Open the cache, creating its directory if needed
+     * @param directory where the entries live
+     * @param config detection settings the cached results must have been produced with
+     * @throws invalid_argument if the directory cannot be created
+     */
+    AnalysisCache(const string &directory, const DetectorConfig &config);
+
+    /**
+     * Look up the results for the file contents
+     * @param contents the whole file
+     * @param summary set to the cached results on a hit
+     * @return true on a hit, false on a miss
+     */
+    bool load(string_view contents, AnalysisSummary &summary);
+
+    /**
+     * Store the results for the file contents. Failing to write is not an error, the
+     * entry is just missing next time.
+     * @param contents the whole file
+     * @param summary results of analyzing the contents
+     */
+    void store(string_view contents, const AnalysisSummary &summary);
+
+    /**
+     * Get the number of lookups that found an entry
+     * @return hit count
+     */
+    size_t getHitCount() const;
+
+    /**
+     * Get the number of lookups that did not find an entry
+     * @return miss count
+     */
+    size_t getMissCount() const;
+
+private:
+    static const char MAGIC[8];
+    static const uint64_t FORMAT_VERSION = 6;
+
+    string directory;
+    uint64_t configurationHash;
+    atomic<size_t> hitCount{0};
+    atomic<size_t> missCount{0};
+    atomic<size_t> temporaryFileCount{0};
+
+    // Path of the entry for contents with the given hash
+    string entryPath(uint64_t contentHash) const;
+
+    // Entry layout: header, then the summary, all integers as native 64-bit words
+    string serialize(uint64_t contentHash, size_t contentSize, const AnalysisSummary &summary) const;
+    bool deserialize(const string &entry, uint64_t contentHash, size_t contentSize,
+                     AnalysisSummary &summary) const;
+
+    // mkdir -p
+    static void makeDirectories(const string &path);
+};
+
+
+#endif //CODESMELLDETECTOR_ANALYSISCACHE_H
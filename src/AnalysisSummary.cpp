@@ -0,0 +1,201 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "AnalysisSummary.h"
+#include "Function.h"
+#include "ShingleSignature.h"
+#include <utility>
+
+using namespace std;
+
+AnalysisSummary::AnalysisSummary() = default;
+
+AnalysisSummary::AnalysisSummary(const CodeSmellDetector &detector) {
+    Span<Function> detectorFunctions = detector.getFunctions();
+    Span<ShingleSignature> shingleSignatures = detector.getShingleSignatures();
+
+    functions.resize(detectorFunctions.size());
+    for (size_t i = 0; i < detectorFunctions.size(); i++) {
+        const Function &function = detectorFunctions[i];
+        FunctionMetrics &metrics = functions[i];
+        metrics.name = string(function.getName());
+        metrics.firstLineNumber = function.getFirstLineNumber();
+        metrics.lastLineNumber = function.getLastLineNumber();
+        metrics.lineCount = function.getNumberOfLinesOfCode();
+        metrics.parameterCount = function.getNumberOfParameters();
+        metrics.characterSignature = detector.getCharacterSignature(i);
+
+        if (!shingleSignatures.empty()) {
+            Span<uint64_t> shingles = shingleSignatures[i].getShingles();
+            metrics.shingles.assign(shingles.begin(), shingles.end());
+        }
+    }
+
+    CodeSmellDetector::OccurrenceVisitor visitor;
+    visitor.longMethod = [this](const CodeSmellDetector::LongMethod &occurrence) {
+        longMethodFunctions.push_back(static_cast<uint32_t>(occurrence.functionIndex));
+    };
+    visitor.longParameterList = [this](const CodeSmellDetector::LongParameterList &occurrence) {
+        longParameterListFunctions.push_back(static_cast<uint32_t>(occurrence.functionIndex));
+    };
+    visitor.cloneGroup = [this](Span<uint32_t> functionIndexes) {
+        cloneGroups.emplace_back(functionIndexes.begin(), functionIndexes.end());
+    };
+    visitor.cloneRegion = [this](size_t tokenCount, Span<CodeSmellDetector::RegionLocation> locations) {
+        cloneRegions.emplace_back(CodeSmellDetector::DUPLICATED_CODE, tokenCount,
+                                  vector<CodeSmellDetector::RegionLocation>(locations.begin(), locations.end()));
+    };
+    visitor.duplicatedCode = [this](const CodeSmellDetector::DuplicatedCode &occurrence) {
+        duplicatePairs.push_back(DuplicatePair{static_cast<uint32_t>(occurrence.functionIndexes.first),
+                                               static_cast<uint32_t>(occurrence.functionIndexes.second),
+                                               occurrence.similarityIndex});
+    };
+    duplicatePairs.reserve(detector.viewDuplicateCodeOccurrences().size());
+    detector.visitOccurrences(visitor);
+
+    comparedPairCount = detector.getComparedPairCount();
+    omittedDuplicateCount = detector.getOmittedDuplicateCount();
+}
+
+AnalysisSummary::AnalysisSummary(vector<FunctionMetrics> functions, vector<uint32_t> longMethodFunctions,
+                                 vector<uint32_t> longParameterListFunctions, vector<DuplicatePair> duplicatePairs,
+                                 vector<vector<uint32_t>> cloneGroups,
+                                 vector<CodeSmellDetector::CloneRegion> cloneRegions, size_t comparedPairCount,
+                                 size_t omittedDuplicateCount) {
+    this->functions = move(functions);
+    this->longMethodFunctions = move(longMethodFunctions);
+    this->longParameterListFunctions = move(longParameterListFunctions);
+    this->duplicatePairs = move(duplicatePairs);
+    this->cloneGroups = move(cloneGroups);
+    this->cloneRegions = move(cloneRegions);
+    this->comparedPairCount = comparedPairCount;
+    this->omittedDuplicateCount = omittedDuplicateCount;
+}
+
+const vector<AnalysisSummary::FunctionMetrics> &AnalysisSummary::getFunctions() const {
+    return functions;
+}
+
+const vector<uint32_t> &AnalysisSummary::getLongMethodFunctions() const {
+    return longMethodFunctions;
+}
+
+const vector<uint32_t> &AnalysisSummary::getLongParameterListFunctions() const {
+    return longParameterListFunctions;
+}
+
+const vector<AnalysisSummary::DuplicatePair> &AnalysisSummary::getDuplicatePairs() const {
+    return duplicatePairs;
+}
+
+const vector<vector<uint32_t>> &AnalysisSummary::getCloneGroups() const {
+    return cloneGroups;
+}
+
+const vector<CodeSmellDetector::CloneRegion> &AnalysisSummary::getCloneRegions() const {
+    return cloneRegions;
+}
+
+size_t AnalysisSummary::getComparedPairCount() const {
+    return comparedPairCount;
+}
+
+size_t AnalysisSummary::getOmittedDuplicateCount() const {
+    return omittedDuplicateCount;
+}
+
+vector<string_view> AnalysisSummary::getFunctionNames() const {
+    vector<string_view> functionNames;
+    functionNames.reserve(functions.size());
+    for (const FunctionMetrics &function : functions) {
+        functionNames.push_back(function.name);
+    }
+    return functionNames;
+}
+
+vector<CodeSmellDetector::LongMethod> AnalysisSummary::getLongMethodOccurrences() const {
+    vector<CodeSmellDetector::LongMethod> occurrences;
+    for (uint32_t index : longMethodFunctions) {
+        occurrences.emplace_back(CodeSmellDetector::LONG_METHOD, functions[index].lineCount,
+                                 functions[index].name, index);
+    }
+    return occurrences;
+}
+
+vector<CodeSmellDetector::LongParameterList> AnalysisSummary::getLongParameterListOccurrences() const {
+    vector<CodeSmellDetector::LongParameterList> occurrences;
+    for (uint32_t index : longParameterListFunctions) {
+        occurrences.emplace_back(CodeSmellDetector::LONG_PARAMETER_LIST, functions[index].parameterCount,
+                                 functions[index].name, index);
+    }
+    return occurrences;
+}
+
+vector<CodeSmellDetector::DuplicatedCode> AnalysisSummary::getDuplicateCodeOccurrences() const {
+    vector<CodeSmellDetector::DuplicatedCode> occurrences;
+    for (const DuplicatePair &pair : duplicatePairs) {
+        occurrences.emplace_back(CodeSmellDetector::DUPLICATED_CODE, pair.similarityIndex,
+                                 functions[pair.firstFunction].name, functions[pair.secondFunction].name,
+                                 pair.firstFunction, pair.secondFunction);
+    }
+    return occurrences;
+}
+
+vector<CodeSmellDetector::CloneGroup> AnalysisSummary::getCloneGroupOccurrences() const {
+    vector<CodeSmellDetector::CloneGroup> occurrences;
+    for (const vector<uint32_t> &group : cloneGroups) {
+        vector<string_view> functionNames;
+        for (uint32_t index : group) {
+            functionNames.push_back(functions[index].name);
+        }
+        occurrences.emplace_back(CodeSmellDetector::DUPLICATED_CODE, move(functionNames),
+                                 vector<size_t>(group.begin(), group.end()));
+    }
+    return occurrences;
+}
+
+void AnalysisSummary::visitOccurrences(const CodeSmellDetector::OccurrenceVisitor &visitor) const {
+    if (visitor.longMethod) {
+        for (uint32_t index : longMethodFunctions) {
+            visitor.longMethod(CodeSmellDetector::LongMethod(CodeSmellDetector::LONG_METHOD, functions[index].lineCount,
+                                                             functions[index].name, index));
+        }
+    }
+    if (visitor.longParameterList) {
+        for (uint32_t index : longParameterListFunctions) {
+            visitor.longParameterList(CodeSmellDetector::LongParameterList(
+                    CodeSmellDetector::LONG_PARAMETER_LIST, functions[index].parameterCount, functions[index].name,
+                    index));
+        }
+    }
+    if (visitor.cloneGroup) {
+        for (const vector<uint32_t> &group : cloneGroups) {
+            visitor.cloneGroup(Span<uint32_t>(group));
+        }
+    }
+    if (visitor.duplicatedCode) {
+        for (const DuplicatePair &pair : duplicatePairs) {
+            visitor.duplicatedCode(CodeSmellDetector::DuplicatedCode(
+                    CodeSmellDetector::DUPLICATED_CODE, pair.similarityIndex, functions[pair.firstFunction].name,
+                    functions[pair.secondFunction].name, pair.firstFunction, pair.secondFunction));
+        }
+    }
+    if (visitor.cloneRegion) {
+        for (const CodeSmellDetector::CloneRegion &region : cloneRegions) {
+            visitor.cloneRegion(region.tokenCount, Span<CodeSmellDetector::RegionLocation>(region.locations));
+        }
+    }
+}
+
+bool AnalysisSummary::hasLongMethodSmell() const {
+    return !longMethodFunctions.empty();
+}
+
+bool AnalysisSummary::hasLongParameterListSmell() const {
+    return !longParameterListFunctions.empty();
+}
+
+bool AnalysisSummary::hasDuplicateCodeSmell() const {
+    return !duplicatePairs.empty() || !cloneGroups.empty() || !cloneRegions.empty();
+}
@@ -0,0 +1,183 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_ANALYSISSUMMARY_H
+#define CODESMELLDETECTOR_ANALYSISSUMMARY_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "CharacterSignature.h"
+#include "CodeSmellDetector.h"
+
+using namespace std;
+
+/**
+ * Self-contained results of analyzing one file: the metrics of every function and the code
+ * smells found. Unlike CodeSmellDetector it owns all of its data, so it can outlive the
+ * file contents and be stored in (and loaded from) the AnalysisCache. Everything needed to
+ * print a report is here, so a file served from the cache is never parsed.
+ */
+class AnalysisSummary {
+public:
+    struct FunctionMetrics {
+        string name;
+        size_t firstLineNumber = 0; // One based, in the analyzed file
+        size_t lastLineNumber = 0;
+        size_t lineCount = 0;
+        int parameterCount = 0;
+        CharacterSignature characterSignature;
+        vector<uint64_t> shingles; // Token shingle set, empty unless the TOKEN_SHINGLE metric is used
+    };
+
+    struct DuplicatePair {
+        uint32_t firstFunction;
+        uint32_t secondFunction;
+        double similarityIndex;
+    };
+
+    /**
+     * Initialize an empty summary
+     */
+    AnalysisSummary();
+
+    /**
+     * Copy the results out of a detector
+     * @param detector detector that analyzed the file
+     */
+    explicit AnalysisSummary(const CodeSmellDetector &detector);
+
+    /**
+     * Initialize the summary from its parts
+     * @param functions metrics of every function, in file order
+     * @param longMethodFunctions indexes of the functions with Long Method
+     * @param longParameterListFunctions indexes of the functions with Long Parameter List
+     * @param duplicatePairs pairs of functions with Duplicated Code
+     * @param cloneGroups indexes of the functions in each group of exact clones
+     * @param cloneRegions repeated runs of tokens and the lines of their copies
+     * @param comparedPairCount number of function pairs compared to find them
+     * @param omittedDuplicateCount number of duplicated pairs left out by the duplicate limit
+     */
+    AnalysisSummary(vector<FunctionMetrics> functions, vector<uint32_t> longMethodFunctions,
+                    vector<uint32_t> longParameterListFunctions, vector<DuplicatePair> duplicatePairs,
+                    vector<vector<uint32_t>> cloneGroups, vector<CodeSmellDetector::CloneRegion> cloneRegions,
+                    size_t comparedPairCount, size_t omittedDuplicateCount);
+
+    /**
+     * Get the metrics of every function
+     * @return functions in file order
+     */
+    const vector<FunctionMetrics> &getFunctions() const;
+
+    /**
+     * Get the indexes of the functions with Long Method
+     * @return indexes into getFunctions()
+     */
+    const vector<uint32_t> &getLongMethodFunctions() const;
+
+    /**
+     * Get the indexes of the functions with Long Parameter List
+     * @return indexes into getFunctions()
+     */
+    const vector<uint32_t> &getLongParameterListFunctions() const;
+
+    /**
+     * Get the pairs of functions with Duplicated Code
+     * @return pairs of indexes into getFunctions()
+     */
+    const vector<DuplicatePair> &getDuplicatePairs() const;
+
+    /**
+     * Get the groups of exact clones
+     * @return indexes into getFunctions() of each group, in file order
+     */
+    const vector<vector<uint32_t>> &getCloneGroups() const;
+
+    /**
+     * Get the clone regions
+     * @return regions ordered by their first copy, see CodeSmellDetector::getCloneRegionOccurrences()
+     */
+    const vector<CodeSmellDetector::CloneRegion> &getCloneRegions() const;
+
+    /**
+     * Get the number of function pairs whose similarity index was computed
+     * @return number of compared pairs, see CodeSmellDetector::getComparedPairCount()
+     */
+    size_t getComparedPairCount() const;
+
+    /**
+     * Get the number of duplicated pairs that are not in getDuplicatePairs() because of the limit
+     * @return number of omitted pairs, see CodeSmellDetector::getOmittedDuplicateCount()
+     */
+    size_t getOmittedDuplicateCount() const;
+
+    /**
+     * Get a list of function names, in the same form as CodeSmellDetector::getFunctionNames()
+     * @return vector of views of the function names, valid as long as the summary
+     */
+    vector<string_view> getFunctionNames() const;
+
+    /**
+     * Get all occurrences of Long Method code smell
+     * @return vector of LongMethod objects whose names point into the summary
+     */
+    vector<CodeSmellDetector::LongMethod> getLongMethodOccurrences() const;
+
+    /**
+     * Get all occurrences of Long Parameter List code smell
+     * @return vector of LongParameterList objects whose names point into the summary
+     */
+    vector<CodeSmellDetector::LongParameterList> getLongParameterListOccurrences() const;
+
+    /**
+     * Get all occurrences of Duplicated Code smell
+     * @return vector of DuplicatedCode objects whose names point into the summary
+     */
+    vector<CodeSmellDetector::DuplicatedCode> getDuplicateCodeOccurrences() const;
+
+    /**
+     * Get all groups of exact clones
+     * @return vector of CloneGroup objects whose names point into the summary
+     */
+    vector<CodeSmellDetector::CloneGroup> getCloneGroupOccurrences() const;
+
+    /**
+     * Same as CodeSmellDetector::visitOccurrences(). Each occurrence is built just for its callback,
+     * so no list of them is ever made.
+     * @param visitor callbacks for the smells of interest
+     */
+    void visitOccurrences(const CodeSmellDetector::OccurrenceVisitor &visitor) const;
+
+    /**
+     * Was Long Method detected?
+     * @return true if detected, false if not
+     */
+    bool hasLongMethodSmell() const;
+
+    /**
+     * Was Long Parameter List detected?
+     * @return true if detected, false if not
+     */
+    bool hasLongParameterListSmell() const;
+
+    /**
+     * Was Duplicated Code detected? Exact clones and clone regions count as Duplicated Code.
+     * @return true if detected, false if not
+     */
+    bool hasDuplicateCodeSmell() const;
+
+private:
+    vector<FunctionMetrics> functions;
+    vector<uint32_t> longMethodFunctions;
+    vector<uint32_t> longParameterListFunctions;
+    vector<DuplicatePair> duplicatePairs;
+    vector<vector<uint32_t>> cloneGroups;
+    vector<CodeSmellDetector::CloneRegion> cloneRegions;
+    size_t comparedPairCount = 0;
+    size_t omittedDuplicateCount = 0;
+};
+
+
+#endif //CODESMELLDETECTOR_ANALYSISSUMMARY_H
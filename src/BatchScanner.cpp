@@ -0,0 +1,160 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "BatchScanner.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <dirent.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+const string BatchScanner::SOURCE_FILE_EXTENSION = ".cpp";
+
+BatchScanner::BatchScanner(size_t threadCount) {
+    this->threadCount = threadCount;
+}
+
+vector<string> BatchScanner::collectSourceFiles(const vector<string> &paths) {
+    vector<string> sourceFiles;
+
+    for (const string &path : paths) {
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) {
+            throw invalid_argument("no such file or directory: [" + path + "]");
+        }
+
+        if (S_ISDIR(info.st_mode)) {
+            collectFromDirectory(path, sourceFiles);
+        } else if (hasSourceExtension(path)) {
+            sourceFiles.push_back(path);
+        } else {
+            throw invalid_argument("input file must have extension [" + SOURCE_FILE_EXTENSION + "]: [" + path + "]");
+        }
+    }
+
+    // Sorting makes the report order independent of directory listing order
+    sort(sourceFiles.begin(), sourceFiles.end());
+    sourceFiles.erase(unique(sourceFiles.begin(), sourceFiles.end()), sourceFiles.end());
+    return sourceFiles;
+}
+
+bool BatchScanner::hasSourceExtension(const string &filename) {
+    size_t dotIndex = filename.find_last_of('.');
+    return dotIndex != string::npos && filename.substr(dotIndex) == SOURCE_FILE_EXTENSION;
+}
+
+void BatchScanner::scan(const vector<string> &filenames, const AnalyzeFunction &analyze,
+                        const EmitFunction &emit) const {
+    size_t fileCount = filenames.size();
+    size_t workerCount = threadCount > 0 ? threadCount : ThreadPool::defaultThreadCount();
+    size_t maxReportsAhead = workerCount * REPORTS_AHEAD_PER_THREAD;
+    vector<string> reports(fileCount);
+    vector<bool> finished(fileCount, false);
+    size_t nextToEmit = 0;
+    bool emitting = false; // A worker is writing reports, the others leave theirs to it
+    mutex emitLock;
+    condition_variable reportsEmitted;
+
+    ThreadPool pool(threadCount);
+    for (size_t i = 0; i < fileCount; i++) {
+        // Files only start once the reports before them are close to written, so a slow file
+        // holds back at most maxReportsAhead finished reports
+        {
+            unique_lock<mutex> guard(emitLock);
+            reportsEmitted.wait(guard, [&] { return i < nextToEmit + maxReportsAhead; });
+            if (nextToEmit == fileCount) {
+                break; // Writing a report failed
+            }
+        }
+
+        pool.submit([&, i] {
+            string report;
+            exception_ptr error;
+            try {
+                report = analyze(filenames[i]);
+            } catch (...) {
+                error = current_exception();
+            }
+
+            unique_lock<mutex> guard(emitLock);
+            reports[i] = move(report);
+            finished[i] = true;
+
+            // Write the longest finished prefix of the file list, outside the lock so finishing
+            // workers do not wait on the output
+            if (!emitting) {
+                emitting = true;
+                while (nextToEmit < fileCount && finished[nextToEmit]) {
+                    string ready = move(reports[nextToEmit]);
+                    string().swap(reports[nextToEmit]);
+                    size_t emitIndex = nextToEmit;
+                    guard.unlock();
+                    try {
+                        emit(filenames[emitIndex], ready);
+                    } catch (...) {
+                        guard.lock();
+                        emitting = false;
+                        nextToEmit = fileCount; // Stop submitting, nothing more can be written
+                        reportsEmitted.notify_all();
+                        throw;
+                    }
+                    guard.lock();
+                    nextToEmit++;
+                    reportsEmitted.notify_all();
+                }
+                emitting = false;
+            }
+
+            if (error) {
+                rethrow_exception(error);
+            }
+        });
+    }
+
+    pool.wait();
+}
+
+void BatchScanner::collectFromDirectory(const string &directory, vector<string> &sourceFiles) {
+    DIR *dir = opendir(directory.c_str());
+    if (dir == nullptr) {
+        throw invalid_argument("error opening directory: [" + directory + "]");
+    }
+
+    vector<string> subdirectories;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        string name = entry->d_name;
+        if (name == "." || name == "..") {
+            continue;
+        }
+
+        string path = joinPath(directory, name);
+        struct stat info;
+        if (lstat(path.c_str(), &info) != 0) {
+            continue;
+        }
+
+        if (S_ISDIR(info.st_mode)) {
+            subdirectories.push_back(path);
+        } else if (S_ISREG(info.st_mode) && hasSourceExtension(name)) {
+            sourceFiles.push_back(path);
+        }
+    }
+    closedir(dir);
+
+    for (const string &subdirectory : subdirectories) {
+        collectFromDirectory(subdirectory, sourceFiles);
+    }
+}
+
+string BatchScanner::joinPath(const string &directory, const string &entry) {
+    if (!directory.empty() && directory.back() == '/') {
+        return directory + entry;
+    }
+    return directory + "/" + entry;
+}
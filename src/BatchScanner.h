@@ -0,0 +1,74 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_BATCHSCANNER_H
+#define CODESMELLDETECTOR_BATCHSCANNER_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Analyzes many source files concurrently. Collects the input files from the paths given
+ * on the command line (descending into directories), runs the analysis for each file on a
+ * work-stealing thread pool and hands the per-file reports back in sorted path order, no
+ * matter which order the workers finish in.
+ */
+class BatchScanner {
+public:
+    // Produces the report for a single file. Runs on a worker thread.
+    typedef function<string(const string &filename)> AnalyzeFunction;
+
+    // Receives each finished report. Always called in path order, one call at a time.
+    typedef function<void(const string &filename, const string &report)> EmitFunction;
+
+    static const string SOURCE_FILE_EXTENSION;
+
+    /**
+     * Initialize the scanner
+     * @param threadCount number of worker threads, 0 uses every hardware thread
+     */
+    explicit BatchScanner(size_t threadCount = 0);
+
+    /**
+     * Collect all source files below the given paths. Directories are searched recursively
+     * (symbolic links to directories are not followed), plain files are taken as given.
+     * @param paths files and directories from the command line
+     * @return sorted list of source files without duplicates
+     * @throws invalid_argument if a path does not exist or is not a source file
+     */
+    static vector<string> collectSourceFiles(const vector<string> &paths);
+
+    /**
+     * Does the filename end with the source file extension?
+     * @param filename name of the file
+     * @return true if it is a source file, false if not
+     */
+    static bool hasSourceExtension(const string &filename);
+
+    /**
+     * Analyze every file and emit the reports in the order of the list. A report is emitted
+     * as soon as it and all reports before it are done. A file is only started once fewer than
+     * REPORTS_AHEAD_PER_THREAD reports per worker are ahead of the last one emitted, so a slow
+     * file early in the list holds back a bounded number of reports.
+     * @param filenames files to analyze
+     * @param analyze per-file analysis
+     * @param emit consumer of the finished reports
+     */
+    void scan(const vector<string> &filenames, const AnalyzeFunction &analyze, const EmitFunction &emit) const;
+
+private:
+    static const size_t REPORTS_AHEAD_PER_THREAD = 4; // Files started past the next report to emit, per worker
+
+    size_t threadCount;
+
+    // Walk a directory tree, appending every source file to the list
+    static void collectFromDirectory(const string &directory, vector<string> &sourceFiles);
+    static string joinPath(const string &directory, const string &entry);
+};
+
+
+#endif //CODESMELLDETECTOR_BATCHSCANNER_H
@@ -0,0 +1,149 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "CharacterSignature.h"
+
+#if defined(__x86_64__)
+#define CODESMELLDETECTOR_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+    typedef void (*CountKernel)(const uint64_t *first, const uint64_t *second,
+                                size_t &intersectionCount, size_t &unionCount);
+
+    void scalarCounts(const uint64_t *first, const uint64_t *second,
+                      size_t &intersectionCount, size_t &unionCount) {
+        intersectionCount = 0;
+        unionCount = 0;
+        for (size_t i = 0; i < CharacterSignature::WORD_COUNT; i++) {
+            intersectionCount += __builtin_popcountll(first[i] & second[i]);
+            unionCount += __builtin_popcountll(first[i] | second[i]);
+        }
+    }
+
+#ifdef CODESMELLDETECTOR_X86
+    __attribute__((target("sse2,popcnt")))
+    void sse2Counts(const uint64_t *first, const uint64_t *second,
+                    size_t &intersectionCount, size_t &unionCount) {
+        const __m128i *a = reinterpret_cast<const __m128i *>(first);
+        const __m128i *b = reinterpret_cast<const __m128i *>(second);
+
+        alignas(16) uint64_t andWords[CharacterSignature::WORD_COUNT];
+        alignas(16) uint64_t orWords[CharacterSignature::WORD_COUNT];
+        __m128i *andOut = reinterpret_cast<__m128i *>(andWords);
+        __m128i *orOut = reinterpret_cast<__m128i *>(orWords);
+
+        for (size_t i = 0; i < CharacterSignature::WORD_COUNT / 2; i++) {
+            __m128i lhs = _mm_loadu_si128(a + i);
+            __m128i rhs = _mm_loadu_si128(b + i);
+            _mm_store_si128(andOut + i, _mm_and_si128(lhs, rhs));
+            _mm_store_si128(orOut + i, _mm_or_si128(lhs, rhs));
+        }
+
+        intersectionCount = 0;
+        unionCount = 0;
+        for (size_t i = 0; i < CharacterSignature::WORD_COUNT; i++) {
+            intersectionCount += _mm_popcnt_u64(andWords[i]);
+            unionCount += _mm_popcnt_u64(orWords[i]);
+        }
+    }
+
+    __attribute__((target("avx2,popcnt")))
+    void avx2Counts(const uint64_t *first, const uint64_t *second,
+                    size_t &intersectionCount, size_t &unionCount) {
+        __m256i lhs = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first));
+        __m256i rhs = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(second));
+        __m256i andBits = _mm256_and_si256(lhs, rhs);
+        __m256i orBits = _mm256_or_si256(lhs, rhs);
+
+        intersectionCount = _mm_popcnt_u64(_mm256_extract_epi64(andBits, 0)) +
+                            _mm_popcnt_u64(_mm256_extract_epi64(andBits, 1)) +
+                            _mm_popcnt_u64(_mm256_extract_epi64(andBits, 2)) +
+                            _mm_popcnt_u64(_mm256_extract_epi64(andBits, 3));
+        unionCount = _mm_popcnt_u64(_mm256_extract_epi64(orBits, 0)) +
+                     _mm_popcnt_u64(_mm256_extract_epi64(orBits, 1)) +
+                     _mm_popcnt_u64(_mm256_extract_epi64(orBits, 2)) +
+                     _mm_popcnt_u64(_mm256_extract_epi64(orBits, 3));
+    }
+#endif
+
+    struct Kernel {
+        CountKernel counts;
+        const char *name;
+    };
+
+    // Pick the widest kernel the CPU supports, once
+    Kernel selectKernel() {
+#ifdef CODESMELLDETECTOR_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+            return Kernel{avx2Counts, "avx2"};
+        }
+        if (__builtin_cpu_supports("sse2") && __builtin_cpu_supports("popcnt")) {
+            return Kernel{sse2Counts, "sse2"};
+        }
+#endif
+        return Kernel{scalarCounts, "scalar"};
+    }
+
+    const Kernel SELECTED_KERNEL = selectKernel();
+}
+
+CharacterSignature::CharacterSignature() {
+    for (uint64_t &word : words) {
+        word = 0;
+    }
+}
+
+CharacterSignature::CharacterSignature(string_view codeString) : CharacterSignature() {
+    add(codeString);
+}
+
+void CharacterSignature::add(char character) {
+    unsigned char bit = static_cast<unsigned char>(character);
+    words[bit / 64] |= uint64_t(1) << (bit % 64);
+}
+
+void CharacterSignature::add(string_view text) {
+    for (char c : text) {
+        add(c);
+    }
+}
+
+bool CharacterSignature::contains(char character) const {
+    unsigned char bit = static_cast<unsigned char>(character);
+    return (words[bit / 64] >> (bit % 64)) & 1;
+}
+
+size_t CharacterSignature::count() const {
+    size_t total = 0;
+    for (uint64_t word : words) {
+        total += __builtin_popcountll(word);
+    }
+    return total;
+}
+
+const uint64_t *CharacterSignature::getWords() const {
+    return words;
+}
+
+CharacterSignature CharacterSignature::fromWords(const uint64_t *words) {
+    CharacterSignature signature;
+    for (size_t i = 0; i < WORD_COUNT; i++) {
+        signature.words[i] = words[i];
+    }
+    return signature;
+}
+
+void CharacterSignature::intersectionAndUnionCounts(const CharacterSignature &first, const CharacterSignature &second,
+                                                    size_t &intersectionCount, size_t &unionCount) {
+    SELECTED_KERNEL.counts(first.words, second.words, intersectionCount, unionCount);
+}
+
+const char *CharacterSignature::kernelName() {
+    return SELECTED_KERNEL.name;
+}
@@ -0,0 +1,93 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_CHARACTERSIGNATURE_H
+#define CODESMELLDETECTOR_CHARACTERSIGNATURE_H
+
+#include <cstdint>
+#include <string_view>
+
+using namespace std;
+
+/**
+ * The set of distinct characters in a piece of code, stored as a fixed 256-bit set with
+ * one bit per byte value. Intersection and union sizes of two signatures are computed with
+ * bitwise AND/OR and popcount, using AVX2 or SSE2 when the CPU supports it.
+ */
+class CharacterSignature {
+public:
+    static const size_t BIT_COUNT = 256;
+    static const size_t WORD_COUNT = BIT_COUNT / 64;
+
+    /**
+     * Initialize an empty signature
+     */
+    CharacterSignature();
+
+    /**
+     * Initialize the signature with every character of the code string
+     * @param codeString code to take the characters from
+     */
+    explicit CharacterSignature(string_view codeString);
+
+    /**
+     * Add a character to the set
+     * @param character the character
+     */
+    void add(char character);
+
+    /**
+     * Add every character of the text to the set
+     * @param text the characters
+     */
+    void add(string_view text);
+
+    /**
+     * Is the character in the set?
+     * @param character the character
+     * @return true if it is, false if not
+     */
+    bool contains(char character) const;
+
+    /**
+     * Get the number of distinct characters in the set
+     * @return set size
+     */
+    size_t count() const;
+
+    /**
+     * Get the raw set bits, for storing the signature
+     * @return array of WORD_COUNT words, bit c of the set is bit (c % 64) of word c / 64
+     */
+    const uint64_t *getWords() const;
+
+    /**
+     * Rebuild a signature from raw set bits
+     * @param words array of WORD_COUNT words, as returned by getWords()
+     * @return the signature
+     */
+    static CharacterSignature fromWords(const uint64_t *words);
+
+    /**
+     * Count the characters in both sets and in either set
+     * @param first first signature
+     * @param second second signature
+     * @param intersectionCount set to the size of the intersection
+     * @param unionCount set to the size of the union
+     */
+    static void intersectionAndUnionCounts(const CharacterSignature &first, const CharacterSignature &second,
+                                           size_t &intersectionCount, size_t &unionCount);
+
+    /**
+     * Name of the kernel picked for this CPU ("avx2", "sse2" or "scalar")
+     * @return kernel name
+     */
+    static const char *kernelName();
+
+private:
+    uint64_t words[WORD_COUNT];
+};
+
+
+#endif //CODESMELLDETECTOR_CHARACTERSIGNATURE_H
@@ -3,131 +3,811 @@
 //
 
 #include "CodeSmellDetector.h"
+#include "DetectorRegistry.h"
 #include "Function.h"
 #include <vector>
 #include <climits>
 #include <algorithm>
-#include <unordered_set>
 #include "Parser.h"
+#include "MinHashIndex.h"
+#include "Hash.h"
+#include "PhaseStats.h"
+#include "SuffixArray.h"
+#include "ThreadPool.h"
+#include "Tokenizer.h"
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
 
 using namespace std;
 
-CodeSmellDetector::CodeSmellDetector(const vector<string> &linesFromFile) {
-    extractFunctions(linesFromFile);
+CodeSmellDetector::CodeSmellDetector(const vector<string_view> &linesFromFile, const DetectorConfig &config)
+        : CodeSmellDetector(linesFromFile, config, nullptr) {
+}
+
+CodeSmellDetector::CodeSmellDetector(const vector<string_view> &linesFromFile, const DetectorConfig &config,
+                                     const vector<LineRange> &changedLines)
+        : CodeSmellDetector(linesFromFile, config, &changedLines) {
+}
+
+CodeSmellDetector::CodeSmellDetector(const vector<string_view> &linesFromFile, const DetectorConfig &config,
+                                     const vector<LineRange> *changedLines)
+        : arena(max<size_t>(linesFromFile.size() * ARENA_BYTES_PER_LINE, 1)),
+          longMethodOccurrences(&arena), longParameterListOccurrences(&arena), duplicatedCodeOccurrences(&arena),
+          functionList(&arena), characterSignatures(&arena), shingleSignatures(&arena), setSizes(&arena),
+          scanOrder(&arena), changedFunctions(&arena), cloneRepresentatives(&arena), cloneGroupMembers(&arena),
+          cloneGroupEnds(&arena), functionTokens(&arena), functionTokenEnds(&arena), tokenLineNumbers(&arena),
+          cloneRegionLocations(&arena), cloneRegionEnds(&arena), cloneRegionTokenCounts(&arena) {
+    this->config = config;
+    this->comparedPairCount = 0;
+    this->prunedPairCount = 0;
+    this->omittedDuplicateCount = 0;
+    this->duplicateScanCancelled = false;
+
+    // The per-function detectors run inside the extraction pass, the pairwise one after it
+    extractFunctions(linesFromFile, changedLines);
+    if (!DetectorRegistry::isEnabled(config, DUPLICATED_CODE)) {
+        return;
+    }
 
-    detectLongMethod();
-    detectLongParameterList();
+    if (config.backgroundDuplicateScan) {
+        // From here on only the scan adds to the arena, so it may run alongside the getters
+        duplicateScan.reset(new ThreadPool(1));
+        duplicateScan->submit([this]() {
+            scanForDuplicates();
+        });
+    } else {
+        scanForDuplicates();
+    }
+}
+
+CodeSmellDetector::~CodeSmellDetector() {
+    // The scan writes into the arena, so it has to be finished before the lists are released.
+    // Nobody will read its results any more, so it stops at the next row, tile or batch.
+    duplicateScanCancelled = true;
+    duplicateScan.reset();
+}
+
+void CodeSmellDetector::scanForDuplicates() {
+    if (config.groupExactClones) {
+        detectExactClones();
+    }
     detectDuplicatedCode();
+    PHASE_ITEMS(DETECT_DUPLICATED_CODE, comparedPairCount);
+    PHASE_ITEMS(FILTER_PAIRS, prunedPairCount);
+    if (config.minCloneRegionTokens > 0) {
+        detectCloneRegions();
+    }
+}
 
-    for (const Function &function : this->functionList) {
-        this->functionNames.push_back(function.getName());
+void CodeSmellDetector::waitForDuplicateScan() const {
+    if (duplicateScan != nullptr) {
+        try {
+            duplicateScan->wait();
+        } catch (...) {
+            duplicateScanError = current_exception();
+        }
+        duplicateScan.reset();
+    }
+    if (duplicateScanError) {
+        rethrow_exception(duplicateScanError);
     }
 }
 
-void CodeSmellDetector::extractFunctions(const vector<string> &linesFromFile) {
-    Parser parser(linesFromFile);
-    vector<vector<string>> functionContentList = parser.getFunctionContentList();
+void CodeSmellDetector::extractFunctions(const vector<string_view> &linesFromFile,
+                                         const vector<LineRange> *changedLines) {
+    vector<const DetectorRegistry::Detector *> functionDetectors = DetectorRegistry::getFunctionDetectors(config);
+    bool buildsSignatures = DetectorRegistry::isEnabled(config, DUPLICATED_CODE);
+    bool lexesTokens = buildsSignatures && (config.similarityMetric == DetectorConfig::TOKEN_SHINGLE
+                                            || config.groupExactClones || config.minCloneRegionTokens > 0);
+    bool keepsTokenLines = buildsSignatures && config.minCloneRegionTokens > 0;
+    vector<uint32_t> lexedTokens;
+    vector<uint32_t> lexedLines;
+
+    // Functions are built as the parser finds them, no intermediate list of contents. Each one is
+    // inspected by every enabled per-function detector and reduced to its signatures right away,
+    // while its lines are still in the cache.
+    {
+        PHASE_SCOPE(PARSE);
+        Parser parser(linesFromFile);
+        parser.forEachFunction([this, &parser, changedLines, &functionDetectors, buildsSignatures,
+                                       lexesTokens, keepsTokenLines, &lexedTokens, &lexedLines](
+                size_t firstLineNumber, size_t lastLineNumber) {
+            Span<string_view> codeLines = parser.getFunctionContent(firstLineNumber, lastLineNumber, &arena);
+            {
+                PHASE_SCOPE(CONSTRUCT_FUNCTIONS);
+                functionList.emplace_back(codeLines, firstLineNumber, lastLineNumber);
+            }
+            size_t functionIndex = functionList.size() - 1;
+            const Function &function = functionList.back();
+
+            if (changedLines != nullptr) {
+                changedFunctions.push_back(LineRange::anyOverlaps(*changedLines, firstLineNumber, lastLineNumber));
+            }
+            if (isChangedFunction(functionIndex) && !functionDetectors.empty()) {
+                PHASE_SCOPE(DETECT_FUNCTION_SMELLS);
+                for (const DetectorRegistry::Detector *detector : functionDetectors) {
+                    size_t measurement;
+                    if (detector->check(function, measurement)) {
+                        recordFunctionSmell(detector->type, functionIndex, measurement);
+                    }
+                }
+            }
+
+            // Lex the function once, every token based engine reads the stored token IDs. The source
+            // lines are lexed rather than the code lines, which leave out blank and comment lines, so
+            // the line index of a token is its offset from the header.
+            if (lexesTokens) {
+                PHASE_SCOPE(LEX_TOKENS);
+                lexedTokens.clear();
+                lexedLines.clear();
+                Tokenizer::lexTokens(parser.getFunctionSource(firstLineNumber, lastLineNumber), lexedTokens,
+                                     lexedLines);
+                functionTokens.insert(functionTokens.end(), lexedTokens.begin(), lexedTokens.end());
+                functionTokenEnds.push_back(static_cast<uint32_t>(functionTokens.size()));
+                if (keepsTokenLines) {
+                    for (uint32_t lineIndex : lexedLines) {
+                        tokenLineNumbers.push_back(static_cast<uint32_t>(firstLineNumber + lineIndex));
+                    }
+                }
+            }
 
-    for (const vector<string> &content : functionContentList) {
-        Function function(content);
-        functionList.push_back(function);
+            // Lay the signatures out contiguously so the duplicate scan never touches the functions
+            if (buildsSignatures) {
+                PHASE_SCOPE(BUILD_SIGNATURES);
+                characterSignatures.push_back(function.computeCharacterSignature());
+                if (config.similarityMetric == DetectorConfig::TOKEN_SHINGLE) {
+                    shingleSignatures.emplace_back(getFunctionTokens(functionIndex), config.shingleSize,
+                                                   config.normalizeIdentifiers, &arena);
+                }
+            }
+        });
     }
+    PHASE_ITEMS(PARSE, linesFromFile.size());
+    PHASE_ITEMS(CONSTRUCT_FUNCTIONS, functionList.size());
+    PHASE_ITEMS(LEX_TOKENS, functionTokens.size());
+    PHASE_ITEMS(DETECT_FUNCTION_SMELLS, functionDetectors.empty() ? 0 : functionList.size());
+    PHASE_ITEMS(BUILD_SIGNATURES, buildsSignatures ? functionList.size() : 0);
 }
 
-void CodeSmellDetector::detectLongMethod() {
-    for (const Function &function : functionList) {
-        size_t functionLineCount = function.getNumberOfLinesOfCode();
+void CodeSmellDetector::recordFunctionSmell(SmellType type, size_t functionIndex, size_t measurement) {
+    const Function &function = functionList[functionIndex];
+    switch (type) {
+        case LONG_METHOD:
+            longMethodOccurrences.emplace_back(LONG_METHOD, measurement, function.getName(), functionIndex);
+            break;
+        case LONG_PARAMETER_LIST:
+            longParameterListOccurrences.emplace_back(LONG_PARAMETER_LIST, static_cast<int>(measurement),
+                                                      function.getName(), functionIndex);
+            break;
+        default:
+            // A detector in the registry without a list to record it in, see DetectorRegistry
+            throw invalid_argument("no occurrence list for code smell: [" + smellTypeToString(type) + "]");
+    }
+}
+
+void CodeSmellDetector::detectExactClones() {
+    PHASE_SCOPE(DETECT_EXACT_CLONES);
+    PHASE_ITEMS(DETECT_EXACT_CLONES, functionList.size());
+
+    // Every function points at the first function with the same body
+    vector<uint64_t> bodyHashes;
+    bodyHashes.reserve(functionList.size());
+    for (size_t i = 0; i < functionList.size(); i++) {
+        bodyHashes.push_back(Tokenizer::hashBody(getFunctionTokens(i)));
+    }
+    auto sameBody = [this](uint32_t first, uint32_t second) {
+        Span<uint32_t> firstBody = Tokenizer::getBody(getFunctionTokens(first));
+        Span<uint32_t> secondBody = Tokenizer::getBody(getFunctionTokens(second));
+        return equal(firstBody.begin(), firstBody.end(), secondBody.begin(), secondBody.end());
+    };
+    vector<uint32_t> representatives = findCloneRepresentatives(bodyHashes, sameBody);
+    cloneRepresentatives.assign(representatives.begin(), representatives.end());
 
-        if (functionLineCount > MAX_LINES_OF_CODE) {
-            LongMethod longMethod(LONG_METHOD, functionLineCount, function.getName());
-            longMethodOccurrences.push_back(longMethod);
+    vector<uint32_t> memberCounts(functionList.size(), 0);
+    vector<bool> groupChanged(functionList.size(), false);
+    for (size_t i = 0; i < functionList.size(); i++) {
+        uint32_t representative = cloneRepresentatives[i];
+        memberCounts[representative]++;
+        if (isChangedFunction(i)) {
+            groupChanged[representative] = true;
+        }
+    }
+
+    // Lay the groups of two or more out one after another, in the order of their first function.
+    // Groups without a changed function are still grouped, just not reported.
+    vector<uint32_t> nextMember(functionList.size(), 0);
+    uint32_t groupEnd = 0;
+    for (size_t i = 0; i < functionList.size(); i++) {
+        if (memberCounts[i] > 1 && groupChanged[i]) {
+            nextMember[i] = groupEnd;
+            groupEnd += memberCounts[i];
+            cloneGroupEnds.push_back(groupEnd);
+        }
+    }
+    cloneGroupMembers.resize(groupEnd);
+    for (size_t i = 0; i < functionList.size(); i++) {
+        uint32_t representative = cloneRepresentatives[i];
+        if (memberCounts[representative] > 1 && groupChanged[representative]) {
+            cloneGroupMembers[nextMember[representative]++] = static_cast<uint32_t>(i);
         }
     }
 }
 
-void CodeSmellDetector::detectLongParameterList() {
-    for (const Function &function : functionList) {
-        int parameterCount = function.getNumberOfParameters();
+void CodeSmellDetector::detectCloneRegions() {
+    PHASE_SCOPE(DETECT_CLONE_REGIONS);
+    PHASE_ITEMS(DETECT_CLONE_REGIONS, functionTokens.size());
 
-        if (parameterCount > MAX_PARAMETER_COUNT) {
-            LongParameterList longParameterList(LONG_PARAMETER_LIST, parameterCount, function.getName());
-            longParameterListOccurrences.push_back(longParameterList);
+    // Tokens as they are compared, with names and literals abstracted if asked to
+    vector<uint32_t> comparedTokens(functionTokens.begin(), functionTokens.end());
+    if (config.normalizeIdentifiers) {
+        for (uint32_t &token : comparedTokens) {
+            token = Tokenizer::normalizeToken(token);
+        }
+    }
+
+    // Number the distinct tokens from 1 and end each function with a symbol of its own, so no
+    // repeat runs from one function into the next. The 0 at the end closes the text.
+    vector<uint32_t> distinctTokens(comparedTokens);
+    sort(distinctTokens.begin(), distinctTokens.end());
+    distinctTokens.erase(unique(distinctTokens.begin(), distinctTokens.end()), distinctTokens.end());
+
+    vector<uint32_t> text;
+    vector<uint32_t> functionStarts; // Parallel to functionList, position of its first token in text
+    text.reserve(comparedTokens.size() + functionList.size() + 1);
+    functionStarts.reserve(functionList.size());
+    uint32_t separator = static_cast<uint32_t>(distinctTokens.size()) + 1;
+    size_t tokenStart = 0;
+    for (uint32_t tokenEnd : functionTokenEnds) {
+        functionStarts.push_back(static_cast<uint32_t>(text.size()));
+        for (size_t i = tokenStart; i < tokenEnd; i++) {
+            auto rank = lower_bound(distinctTokens.begin(), distinctTokens.end(), comparedTokens[i]);
+            text.push_back(static_cast<uint32_t>(rank - distinctTokens.begin()) + 1);
+        }
+        text.push_back(separator++);
+        tokenStart = tokenEnd;
+    }
+    text.push_back(0);
+    SuffixArray suffixArray(move(text), separator);
+
+    struct Region {
+        uint32_t firstPosition;
+        uint32_t tokenCount;
+        vector<RegionLocation> locations;
+    };
+    vector<Region> regions;
+    vector<uint32_t> positions;
+    suffixArray.forEachMaximalRepeat(config.minCloneRegionTokens, [this, &functionStarts, &regions, &positions](
+            size_t length, Span<uint32_t> repeatPositions) {
+        if (duplicateScanCancelled) {
+            return;
+        }
+        positions.assign(repeatPositions.begin(), repeatPositions.end());
+        sort(positions.begin(), positions.end());
+
+        // Text positions are token positions pushed back by one separator per earlier function.
+        // A copy that overlaps the one before it in the same function is left out.
+        vector<RegionLocation> locations;
+        bool changed = false;
+        size_t previousEnd = 0;
+        for (uint32_t position : positions) {
+            size_t functionIndex = upper_bound(functionStarts.begin(), functionStarts.end(), position)
+                                   - functionStarts.begin() - 1;
+            if (!locations.empty() && locations.back().functionIndex == functionIndex && position < previousEnd) {
+                continue;
+            }
+            size_t firstToken = position - functionIndex;
+            locations.push_back(RegionLocation{functionIndex, tokenLineNumbers[firstToken],
+                                               tokenLineNumbers[firstToken + length - 1]});
+            changed = changed || isChangedFunction(functionIndex);
+            previousEnd = position + length;
+        }
+        if (locations.size() > 1 && changed) {
+            regions.push_back(Region{positions[0], static_cast<uint32_t>(length), move(locations)});
         }
+    });
+
+    sort(regions.begin(), regions.end(), [](const Region &first, const Region &second) {
+        return first.firstPosition != second.firstPosition ? first.firstPosition < second.firstPosition
+                                                           : first.tokenCount > second.tokenCount;
+    });
+    cloneRegionEnds.reserve(regions.size());
+    cloneRegionTokenCounts.reserve(regions.size());
+    for (const Region &region : regions) {
+        cloneRegionLocations.insert(cloneRegionLocations.end(), region.locations.begin(), region.locations.end());
+        cloneRegionEnds.push_back(static_cast<uint32_t>(cloneRegionLocations.size()));
+        cloneRegionTokenCounts.push_back(region.tokenCount);
     }
 }
 
 void CodeSmellDetector::detectDuplicatedCode() {
-    size_t numFunctions = functionList.size();
+    PHASE_SCOPE(DETECT_DUPLICATED_CODE);
+    DuplicateCollector collector(config, functionList.size());
+    orderBySetSize();
+
+    if (!changedFunctions.empty()) {
+        detectDuplicatedCodeOfChangedFunctions(collector);
+        recordDuplicates(collector);
+        return;
+    }
+
+    if (config.duplicateSearch == DetectorConfig::LSH) {
+        detectDuplicatedCodeWithLsh(collector);
+        recordDuplicates(collector);
+        return;
+    }
+
+    // Functions taking part in the pair scan, one per clone group
+    size_t numFunctions = scanOrder.size();
+    size_t threadCount = config.pairScanThreadCount == 0 ? ThreadPool::defaultThreadCount()
+                                                         : config.pairScanThreadCount;
 
-    for (size_t i = 0; i < numFunctions - 1; i++) {
-        for (size_t j = i + 1; j < numFunctions; j++) {
-            Function firstFunction = functionList[i];
-            Function secondFunction = functionList[j];
+    // Prefix filtering pays off for the large shingle sets of files with more than a handful of
+    // functions, not for character sets. Threads only pay off once there is more than one tile of pairs.
+    if (config.pruneCandidatePairs && config.similarityMetric == DetectorConfig::TOKEN_SHINGLE
+        && numFunctions >= PREFIX_FILTER_MIN_FUNCTIONS) {
+        detectDuplicatedCodeWithPrefixFilter(collector, threadCount);
+    } else if (threadCount > 1 && numFunctions > PAIR_TILE_SIZE) {
+        detectDuplicatedCodeInTiles(collector, threadCount);
+    } else {
+        for (size_t i = 0; i + 1 < numFunctions && !duplicateScanCancelled; i++) {
+            size_t scanEnd = pairScanEnd(i);
+            for (size_t j = i + 1; j < scanEnd; j++) {
+                comparePair(scanOrder[i], scanOrder[j], collector);
+            }
+            comparedPairCount += scanEnd - i - 1;
+        }
+    }
 
-            double similarityIndex = jaccardSimilarityIndex(firstFunction.getCodeString(),
-                                                            secondFunction.getCodeString());
+    prunedPairCount = numFunctions * (numFunctions - 1) / 2 - comparedPairCount;
+    recordDuplicates(collector);
+}
 
-            if (similarityIndex > MAX_SIMILARITY_INDEX) {
-                DuplicatedCode duplicatedCode(DUPLICATED_CODE, similarityIndex,
-                                              firstFunction.getName(), secondFunction.getName());
-                duplicatedCodeOccurrences.push_back(duplicatedCode);
+void CodeSmellDetector::detectDuplicatedCodeOfChangedFunctions(DuplicateCollector &collector) {
+    // A pair of two changed functions is compared once, from its first function
+    for (size_t i = 0; i < scanOrder.size() && !duplicateScanCancelled; i++) {
+        uint32_t changedIndex = scanOrder[i];
+        if (!changedFunctions[changedIndex]) {
+            continue;
+        }
+        for (uint32_t otherIndex : scanOrder) {
+            if (otherIndex != changedIndex && !(changedFunctions[otherIndex] && otherIndex < changedIndex)) {
+                compareFunctions(changedIndex, otherIndex, collector);
             }
         }
     }
 }
 
-double CodeSmellDetector::jaccardSimilarityIndex(const string &firstCodeString, const string &secondCodeString) {
-    unordered_set<char> firstChars;
-    unordered_set<char> secondChars;
+void CodeSmellDetector::detectDuplicatedCodeWithLsh(DuplicateCollector &collector) {
+    MinHashIndex index(config.lshBandCount, config.lshRowsPerBand);
+    vector<uint32_t> minHashSignature(index.getSignatureLength());
+    vector<uint32_t> candidates;
+
+    // Each function is compared with the candidates added before it, so every candidate pair
+    // comes up once and only one function's candidates are held at a time. The collector puts
+    // the hits back in file order.
+    for (size_t scanIndex = 0; scanIndex < scanOrder.size() && !duplicateScanCancelled; scanIndex++) {
+        uint32_t i = scanOrder[scanIndex];
+        if (config.similarityMetric == DetectorConfig::TOKEN_SHINGLE) {
+            index.computeSignature(shingleSignatures[i].getShingles(), minHashSignature.data());
+        } else {
+            index.computeSignature(characterSignatures[i], minHashSignature.data());
+        }
+        index.getCandidates(minHashSignature.data(), candidates);
+        for (uint32_t candidate : candidates) {
+            compareFunctions(candidate, i, collector);
+        }
+        index.add(i, minHashSignature.data());
+    }
+}
+
+void CodeSmellDetector::detectDuplicatedCodeInTiles(DuplicateCollector &collector, size_t threadCount) {
+    size_t numFunctions = scanOrder.size();
+    size_t blockCount = (numFunctions + PAIR_TILE_SIZE - 1) / PAIR_TILE_SIZE;
 
-    // Get char sets for each function
-    fillCharSet(firstChars, firstCodeString);
-    fillCharSet(secondChars, secondCodeString);
+    // Tiles on or above the diagonal, row by row
+    vector<pair<size_t, size_t>> tiles;
+    for (size_t rowBlock = 0; rowBlock < blockCount; rowBlock++) {
+        for (size_t columnBlock = rowBlock; columnBlock < blockCount; columnBlock++) {
+            tiles.emplace_back(rowBlock, columnBlock);
+        }
+    }
+    threadCount = min(threadCount, tiles.size());
 
-    // Intersection of chars across both functions
-    size_t matchingChars = 0;
-    for (const char &currentChar : firstChars) {
-        // If char from first function is also a char in second function
-        if (secondChars.find(currentChar) != secondChars.end()) {
-            matchingChars++;
+    // Workers take the next tile off a shared counter and keep their hits to themselves
+    vector<DuplicateCollector> workerCollectors(threadCount, DuplicateCollector(config, functionList.size()));
+    atomic<size_t> nextTile{0};
+    atomic<size_t> comparedCount{0};
+    {
+        ThreadPool pool(threadCount);
+        for (size_t worker = 0; worker < threadCount; worker++) {
+            pool.submit([this, &tiles, &workerCollectors, &nextTile, &comparedCount, worker]() {
+                size_t workerComparedCount = 0;
+                for (size_t tile = nextTile++; tile < tiles.size() && !duplicateScanCancelled; tile = nextTile++) {
+                    workerComparedCount += scanTile(tiles[tile].first, tiles[tile].second, workerCollectors[worker]);
+                }
+                comparedCount += workerComparedCount;
+            });
         }
+        pool.wait();
+    }
+
+    // The collector puts the hits back in file order, whichever worker found them
+    for (const DuplicateCollector &workerCollector : workerCollectors) {
+        collector.merge(workerCollector);
     }
+    comparedPairCount += comparedCount;
+}
+
+size_t CodeSmellDetector::scanTile(size_t rowBlock, size_t columnBlock, DuplicateCollector &collector) const {
+    size_t numFunctions = scanOrder.size();
+    size_t rowEnd = min((rowBlock + 1) * PAIR_TILE_SIZE, numFunctions);
+    size_t columnStart = columnBlock * PAIR_TILE_SIZE;
+    size_t columnEnd = min(columnStart + PAIR_TILE_SIZE, numFunctions);
+    size_t comparedCount = 0;
 
-    // All unique chars in either function (we can initialize using number of unique
-    // chars from first function since either set is a subset of the union set)
-    size_t totalUniqueChars = firstChars.size();
-    for (const char &currentChar : secondChars) {
-        // If we haven't recorded unique char from second function yet
-        if (firstChars.find(currentChar) == firstChars.end()) {
-            totalUniqueChars++;
+    for (size_t i = rowBlock * PAIR_TILE_SIZE; i < rowEnd; i++) {
+        size_t firstColumn = max(columnStart, i + 1);
+        size_t lastColumn = min(columnEnd, pairScanEnd(i));
+        for (size_t j = firstColumn; j < lastColumn; j++) {
+            comparePair(scanOrder[i], scanOrder[j], collector);
         }
+        comparedCount += lastColumn > firstColumn ? lastColumn - firstColumn : 0;
+    }
+    return comparedCount;
+}
+
+void CodeSmellDetector::detectDuplicatedCodeWithPrefixFilter(DuplicateCollector &collector, size_t threadCount) {
+    size_t numFunctions = scanOrder.size();
+    unique_ptr<PrefixFilterIndex> index;
+    {
+        PHASE_SCOPE(FILTER_PAIRS);
+        vector<Span<uint64_t>> shingleSets;
+        shingleSets.reserve(numFunctions);
+        for (uint32_t functionIndex : scanOrder) {
+            shingleSets.push_back(shingleSignatures[functionIndex].getShingles());
+        }
+        index.reset(new PrefixFilterIndex(shingleSets, MAX_SIMILARITY_INDEX));
+    }
+
+    if (threadCount <= 1 || numFunctions <= PROBE_BATCH_SIZE) {
+        PrefixFilterIndex::Probe probe;
+        comparedPairCount += probeFunctions(*index, 0, numFunctions, probe, collector);
+        return;
+    }
+
+    // Larger functions probe longer posting lists, so workers take small batches as they go
+    size_t batchCount = (numFunctions + PROBE_BATCH_SIZE - 1) / PROBE_BATCH_SIZE;
+    threadCount = min(threadCount, batchCount);
+    vector<DuplicateCollector> workerCollectors(threadCount, DuplicateCollector(config, functionList.size()));
+    atomic<size_t> nextBatch{0};
+    atomic<size_t> comparedCount{0};
+    {
+        ThreadPool pool(threadCount);
+        for (size_t worker = 0; worker < threadCount; worker++) {
+            pool.submit([this, &index, &workerCollectors, &nextBatch, &comparedCount, batchCount, numFunctions,
+                                worker]() {
+                PrefixFilterIndex::Probe probe;
+                size_t workerComparedCount = 0;
+                for (size_t batch = nextBatch++; batch < batchCount && !duplicateScanCancelled; batch = nextBatch++) {
+                    size_t firstPosition = batch * PROBE_BATCH_SIZE;
+                    size_t lastPosition = min(firstPosition + PROBE_BATCH_SIZE, numFunctions);
+                    workerComparedCount += probeFunctions(*index, firstPosition, lastPosition, probe,
+                                                          workerCollectors[worker]);
+                }
+                comparedCount += workerComparedCount;
+            });
+        }
+        pool.wait();
+    }
+
+    for (const DuplicateCollector &workerCollector : workerCollectors) {
+        collector.merge(workerCollector);
+    }
+    comparedPairCount += comparedCount;
+}
+
+size_t CodeSmellDetector::probeFunctions(const PrefixFilterIndex &index, size_t firstPosition, size_t lastPosition,
+                                         PrefixFilterIndex::Probe &probe, DuplicateCollector &collector) const {
+    size_t comparedCount = 0;
+    for (size_t position = firstPosition; position < lastPosition && !duplicateScanCancelled; position++) {
+        index.findCandidates(position, probe);
+        for (uint32_t candidate : probe.candidates) {
+            comparePair(scanOrder[position], scanOrder[candidate], collector);
+        }
+        comparedCount += probe.candidates.size();
+    }
+    return comparedCount;
+}
+
+void CodeSmellDetector::orderBySetSize() {
+    PHASE_SCOPE(FILTER_PAIRS);
+    setSizes.reserve(functionList.size());
+    for (size_t i = 0; i < functionList.size(); i++) {
+        size_t setSize = config.similarityMetric == DetectorConfig::TOKEN_SHINGLE ? shingleSignatures[i].count()
+                                                                                  : characterSignatures[i].count();
+        setSizes.push_back(static_cast<uint32_t>(setSize));
+    }
+
+    // Other members of a clone group are represented by its first function
+    scanOrder.reserve(functionList.size());
+    for (size_t i = 0; i < functionList.size(); i++) {
+        if (cloneRepresentatives.empty() || cloneRepresentatives[i] == i) {
+            scanOrder.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    if (config.pruneCandidatePairs) {
+        stable_sort(scanOrder.begin(), scanOrder.end(), [this](uint32_t first, uint32_t second) {
+            return setSizes[first] < setSizes[second];
+        });
+    }
+}
+
+size_t CodeSmellDetector::pairScanEnd(size_t position) const {
+    // Sets only grow along scanOrder, so once one later function is too large, all the rest are too
+    size_t low = position + 1;
+    size_t high = scanOrder.size();
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (sizesMayBeDuplicated(scanOrder[position], scanOrder[middle])) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+bool CodeSmellDetector::sizesMayBeDuplicated(size_t firstIndex, size_t secondIndex) const {
+    if (!config.pruneCandidatePairs) {
+        return true;
+    }
+
+    // At best the smaller set lies entirely inside the larger one
+    size_t smallerSize = min(setSizes[firstIndex], setSizes[secondIndex]);
+    size_t largerSize = max(setSizes[firstIndex], setSizes[secondIndex]);
+    return largerSize > 0 && isDuplicatedCode(static_cast<double>(smallerSize) / static_cast<double>(largerSize));
+}
+
+void CodeSmellDetector::compareFunctions(size_t firstIndex, size_t secondIndex, DuplicateCollector &collector) {
+    if (!sizesMayBeDuplicated(firstIndex, secondIndex)) {
+        prunedPairCount++;
+        return;
+    }
+
+    comparedPairCount++;
+    comparePair(firstIndex, secondIndex, collector);
+}
+
+void CodeSmellDetector::comparePair(size_t firstIndex, size_t secondIndex, DuplicateCollector &collector) const {
+    if (firstIndex > secondIndex) {
+        swap(firstIndex, secondIndex);
+    }
+
+    double pairSimilarityIndex = similarityIndex(firstIndex, secondIndex);
+    if (isDuplicatedCode(pairSimilarityIndex)) {
+        collector.add(DuplicateCollector::Hit{static_cast<uint32_t>(firstIndex), static_cast<uint32_t>(secondIndex),
+                                              pairSimilarityIndex});
+    }
+}
+
+void CodeSmellDetector::recordDuplicates(const DuplicateCollector &collector) {
+    // Only kept pairs pay for touching the functions themselves
+    vector<DuplicateCollector::Hit> hits = collector.getHits();
+    duplicatedCodeOccurrences.reserve(hits.size());
+    for (const DuplicateCollector::Hit &hit : hits) {
+        duplicatedCodeOccurrences.emplace_back(DUPLICATED_CODE, hit.similarityIndex,
+                                               functionList[hit.firstIndex].getName(),
+                                               functionList[hit.secondIndex].getName(),
+                                               hit.firstIndex, hit.secondIndex);
+    }
+    omittedDuplicateCount = collector.getDroppedCount();
+}
+
+double CodeSmellDetector::similarityIndex(size_t firstIndex, size_t secondIndex) const {
+    if (config.similarityMetric == DetectorConfig::TOKEN_SHINGLE) {
+        return jaccardSimilarityIndex(shingleSignatures[firstIndex].getShingles(),
+                                      shingleSignatures[secondIndex].getShingles());
+    }
+    return jaccardSimilarityIndex(characterSignatures[firstIndex], characterSignatures[secondIndex]);
+}
+
+double CodeSmellDetector::jaccardSimilarityIndex(const CharacterSignature &firstSignature,
+                                                 const CharacterSignature &secondSignature) {
+    // Intersection of chars across both functions, and all unique chars in either function
+    size_t matchingChars;
+    size_t totalUniqueChars;
+    CharacterSignature::intersectionAndUnionCounts(firstSignature, secondSignature,
+                                                   matchingChars, totalUniqueChars);
+
+    if (totalUniqueChars == 0) {
+        return 0.0;
     }
 
     return static_cast<double>(matchingChars) / static_cast<double>(totalUniqueChars);
 }
 
-void CodeSmellDetector::fillCharSet(unordered_set<char> &charSet, const string &codeString) {
-    for (char c : codeString) {
-        charSet.insert(c);
+double CodeSmellDetector::jaccardSimilarityIndex(Span<uint64_t> firstShingles, Span<uint64_t> secondShingles) {
+    size_t matchingShingles;
+    size_t totalUniqueShingles;
+    ShingleSignature::intersectionAndUnionCounts(firstShingles, secondShingles,
+                                                 matchingShingles, totalUniqueShingles);
+
+    if (totalUniqueShingles == 0) {
+        return 0.0;
+    }
+
+    return static_cast<double>(matchingShingles) / static_cast<double>(totalUniqueShingles);
+}
+
+vector<uint32_t> CodeSmellDetector::findCloneRepresentatives(const vector<uint64_t> &bodyHashes,
+                                                             const function<bool(uint32_t, uint32_t)> &sameBody) {
+    vector<uint32_t> representatives(bodyHashes.size());
+    unordered_map<uint64_t, vector<uint32_t>> firstsWithHash;
+    for (size_t i = 0; i < bodyHashes.size(); i++) {
+        representatives[i] = static_cast<uint32_t>(i);
+        vector<uint32_t> &candidates = firstsWithHash[bodyHashes[i]];
+        for (uint32_t candidate : candidates) {
+            if (sameBody(candidate, static_cast<uint32_t>(i))) {
+                representatives[i] = candidate;
+                break;
+            }
+        }
+        if (representatives[i] == i) {
+            candidates.push_back(representatives[i]);
+        }
     }
+    return representatives;
 }
 
-vector<string> CodeSmellDetector::getFunctionNames() const {
+bool CodeSmellDetector::isLongMethod(size_t lineCount) {
+    return lineCount > MAX_LINES_OF_CODE;
+}
+
+bool CodeSmellDetector::isLongParameterList(int parameterCount) {
+    return parameterCount > MAX_PARAMETER_COUNT;
+}
+
+bool CodeSmellDetector::isDuplicatedCode(double similarityIndex) {
+    return similarityIndex > MAX_SIMILARITY_INDEX;
+}
+
+vector<string_view> CodeSmellDetector::getFunctionNames() const {
+    vector<string_view> functionNames;
+    functionNames.reserve(functionList.size());
+    for (const Function &function : functionList) {
+        functionNames.push_back(function.getName());
+    }
     return functionNames;
 }
 
+Span<Function> CodeSmellDetector::getFunctions() const {
+    return functionList;
+}
+
+bool CodeSmellDetector::isChangedFunction(size_t functionIndex) const {
+    return changedFunctions.empty() || changedFunctions[functionIndex];
+}
+
+Span<ShingleSignature> CodeSmellDetector::getShingleSignatures() const {
+    return shingleSignatures;
+}
+
+Span<uint32_t> CodeSmellDetector::getFunctionTokens(size_t functionIndex) const {
+    if (functionTokenEnds.empty()) {
+        return Span<uint32_t>();
+    }
+    size_t tokenStart = functionIndex == 0 ? 0 : functionTokenEnds[functionIndex - 1];
+    return Span<uint32_t>(functionTokens.data() + tokenStart, functionTokenEnds[functionIndex] - tokenStart);
+}
+
+CharacterSignature CodeSmellDetector::getCharacterSignature(size_t functionIndex) const {
+    if (characterSignatures.empty()) {
+        return functionList[functionIndex].computeCharacterSignature();
+    }
+    return characterSignatures[functionIndex];
+}
+
 vector<CodeSmellDetector::LongParameterList> CodeSmellDetector::getLongParameterListOccurrences() const {
-    return longParameterListOccurrences;
+    Span<LongParameterList> occurrences = viewLongParameterListOccurrences();
+    return vector<LongParameterList>(occurrences.begin(), occurrences.end());
 }
 
 vector<CodeSmellDetector::DuplicatedCode> CodeSmellDetector::getDuplicateCodeOccurrences() const {
-    return duplicatedCodeOccurrences;
+    Span<DuplicatedCode> occurrences = viewDuplicateCodeOccurrences();
+    return vector<DuplicatedCode>(occurrences.begin(), occurrences.end());
+}
+
+vector<CodeSmellDetector::CloneGroup> CodeSmellDetector::getCloneGroupOccurrences() const {
+    waitForDuplicateScan();
+    vector<CloneGroup> occurrences;
+    occurrences.reserve(cloneGroupEnds.size());
+    size_t groupStart = 0;
+    for (uint32_t groupEnd : cloneGroupEnds) {
+        vector<string_view> functionNames;
+        vector<size_t> functionIndexes;
+        for (size_t i = groupStart; i < groupEnd; i++) {
+            functionNames.push_back(functionList[cloneGroupMembers[i]].getName());
+            functionIndexes.push_back(cloneGroupMembers[i]);
+        }
+        occurrences.emplace_back(DUPLICATED_CODE, move(functionNames), move(functionIndexes));
+        groupStart = groupEnd;
+    }
+    return occurrences;
+}
+
+vector<CodeSmellDetector::CloneRegion> CodeSmellDetector::getCloneRegionOccurrences() const {
+    waitForDuplicateScan();
+    vector<CloneRegion> occurrences;
+    occurrences.reserve(cloneRegionEnds.size());
+    size_t regionStart = 0;
+    for (size_t i = 0; i < cloneRegionEnds.size(); i++) {
+        vector<RegionLocation> locations(cloneRegionLocations.begin() + regionStart,
+                                         cloneRegionLocations.begin() + cloneRegionEnds[i]);
+        occurrences.emplace_back(DUPLICATED_CODE, cloneRegionTokenCounts[i], move(locations));
+        regionStart = cloneRegionEnds[i];
+    }
+    return occurrences;
 }
 
 vector<CodeSmellDetector::LongMethod> CodeSmellDetector::getLongMethodOccurrences() const {
+    Span<LongMethod> occurrences = viewLongMethodOccurrences();
+    return vector<LongMethod>(occurrences.begin(), occurrences.end());
+}
+
+Span<CodeSmellDetector::LongMethod> CodeSmellDetector::viewLongMethodOccurrences() const {
     return longMethodOccurrences;
 }
 
+Span<CodeSmellDetector::LongParameterList> CodeSmellDetector::viewLongParameterListOccurrences() const {
+    return longParameterListOccurrences;
+}
+
+Span<CodeSmellDetector::DuplicatedCode> CodeSmellDetector::viewDuplicateCodeOccurrences() const {
+    waitForDuplicateScan();
+    return duplicatedCodeOccurrences;
+}
+
+void CodeSmellDetector::visitOccurrences(const OccurrenceVisitor &visitor) const {
+    if (visitor.longMethod) {
+        for (const LongMethod &occurrence : longMethodOccurrences) {
+            visitor.longMethod(occurrence);
+        }
+    }
+    if (visitor.longParameterList) {
+        for (const LongParameterList &occurrence : longParameterListOccurrences) {
+            visitor.longParameterList(occurrence);
+        }
+    }
+    if (!visitor.cloneGroup && !visitor.duplicatedCode && !visitor.cloneRegion) {
+        return;
+    }
+
+    waitForDuplicateScan();
+    if (visitor.cloneGroup) {
+        size_t groupStart = 0;
+        for (uint32_t groupEnd : cloneGroupEnds) {
+            visitor.cloneGroup(Span<uint32_t>(cloneGroupMembers.data() + groupStart, groupEnd - groupStart));
+            groupStart = groupEnd;
+        }
+    }
+    if (visitor.duplicatedCode) {
+        for (const DuplicatedCode &occurrence : duplicatedCodeOccurrences) {
+            visitor.duplicatedCode(occurrence);
+        }
+    }
+    if (visitor.cloneRegion) {
+        size_t regionStart = 0;
+        for (size_t i = 0; i < cloneRegionEnds.size(); i++) {
+            visitor.cloneRegion(cloneRegionTokenCounts[i], Span<RegionLocation>(
+                    cloneRegionLocations.data() + regionStart, cloneRegionEnds[i] - regionStart));
+            regionStart = cloneRegionEnds[i];
+        }
+    }
+}
+
 string CodeSmellDetector::smellTypeToString(CodeSmellDetector::SmellType type) {
     if (type == LONG_METHOD)
         return "Long Method";
@@ -149,5 +829,43 @@ bool CodeSmellDetector::hasLongParameterListSmell() const {
 }
 
 bool CodeSmellDetector::hasDuplicateCodeSmell() const {
-    return !duplicatedCodeOccurrences.empty();
+    waitForDuplicateScan();
+    return !duplicatedCodeOccurrences.empty() || !cloneGroupEnds.empty() || !cloneRegionEnds.empty();
+}
+
+size_t CodeSmellDetector::getComparedPairCount() const {
+    waitForDuplicateScan();
+    return comparedPairCount;
+}
+
+size_t CodeSmellDetector::getPrunedPairCount() const {
+    waitForDuplicateScan();
+    return prunedPairCount;
+}
+
+size_t CodeSmellDetector::getOmittedDuplicateCount() const {
+    waitForDuplicateScan();
+    return omittedDuplicateCount;
+}
+
+uint64_t CodeSmellDetector::configurationHash(const DetectorConfig &config) {
+    uint64_t similarityThresholdBits;
+    memcpy(&similarityThresholdBits, &MAX_SIMILARITY_INDEX, sizeof(similarityThresholdBits));
+
+    uint64_t hash = Hash::mix(ANALYSIS_VERSION);
+    hash = Hash::combine(hash, MAX_LINES_OF_CODE);
+    hash = Hash::combine(hash, MAX_PARAMETER_COUNT);
+    hash = Hash::combine(hash, similarityThresholdBits);
+    hash = Hash::combine(hash, config.enabledSmells & DetectorRegistry::allSmells());
+    hash = Hash::combine(hash, config.duplicateSearch);
+    hash = Hash::combine(hash, config.similarityMetric);
+    hash = Hash::combine(hash, config.shingleSize);
+    hash = Hash::combine(hash, config.normalizeIdentifiers);
+    hash = Hash::combine(hash, config.lshBandCount);
+    hash = Hash::combine(hash, config.lshRowsPerBand);
+    hash = Hash::combine(hash, config.groupExactClones);
+    hash = Hash::combine(hash, config.minCloneRegionTokens);
+    hash = Hash::combine(hash, config.duplicateLimit);
+    hash = Hash::combine(hash, config.duplicateLimitScope);
+    return hash;
 }
\ No newline at end of file
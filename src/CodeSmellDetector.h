@@ -5,16 +5,40 @@
 #ifndef CODESMELLDETECTOR_CODESMELLDETECTOR_H
 #define CODESMELLDETECTOR_CODESMELLDETECTOR_H
 
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
-#include <unordered_set>
 #include "Function.h"
+#include "CharacterSignature.h"
+#include "DetectorConfig.h"
+#include "DuplicateCollector.h"
+#include "LineRange.h"
+#include "PrefixFilterIndex.h"
+#include "ShingleSignature.h"
+#include "Span.h"
+#include "ThreadPool.h"
 
 using namespace std;
 
 /**
  * Detects three types of code smells: Long Method, Long Parameter List, and Duplicated Code.
- * Takes a list of lines of code from the file as input.
+ * DetectorConfig::enabledSmells can narrow that down, see DetectorRegistry.
+ * Takes a list of lines of code from the file as input. The lines are views into the file
+ * contents, which must outlive the detector, and so must anything returned by it: function
+ * names are views into the same contents. Everything the analysis builds lives in one arena
+ * that is released in a single step when the detector goes away.
+ *
+ * With DetectorConfig::backgroundDuplicateScan the constructor returns as soon as the file is
+ * parsed and the per-function smells are known, and the duplicate scan goes on in the background.
+ * The Duplicated Code getters wait for it the first time they are called; the results are kept,
+ * so later calls return at once. Getters must all be called from the same thread.
  */
 class CodeSmellDetector {
 
@@ -23,54 +47,167 @@ public:
         LONG_METHOD, LONG_PARAMETER_LIST, DUPLICATED_CODE
     };
 
+    // Occurrences also carry the position of the function(s) in getFunctions()
     struct LongMethod {
         SmellType type;
         size_t lineCount;
-        string functionName;
+        string_view functionName;
+        size_t functionIndex;
 
-        LongMethod(SmellType type, size_t lineCount, const string &functionName) {
+        LongMethod(SmellType type, size_t lineCount, string_view functionName, size_t functionIndex) {
             this->type = type;
             this->lineCount = lineCount;
             this->functionName = functionName;
+            this->functionIndex = functionIndex;
         }
     };
 
     struct LongParameterList  {
         SmellType type;
         int parameterCount;
-        string functionName;
+        string_view functionName;
+        size_t functionIndex;
 
-        LongParameterList(SmellType type, int parameterCount, const string &functionName) {
+        LongParameterList(SmellType type, int parameterCount, string_view functionName, size_t functionIndex) {
             this->type = type;
             this->parameterCount = parameterCount;
             this->functionName = functionName;
+            this->functionIndex = functionIndex;
         }
     };
 
     struct DuplicatedCode  {
         SmellType type;
         double similarityIndex;
-        pair<string, string> functionNames;
+        pair<string_view, string_view> functionNames;
+        pair<size_t, size_t> functionIndexes;
 
-        DuplicatedCode(SmellType type, double similarityIndex, const string &functionOne, const string &functionTwo) {
+        DuplicatedCode(SmellType type, double similarityIndex, string_view functionOne, string_view functionTwo,
+                       size_t functionOneIndex, size_t functionTwoIndex) {
             this->type = type;
             this->similarityIndex = similarityIndex;
-            this->functionNames = pair<string, string>(functionOne, functionTwo);
+            this->functionNames = pair<string_view, string_view>(functionOne, functionTwo);
+            this->functionIndexes = pair<size_t, size_t>(functionOneIndex, functionTwoIndex);
         }
     };
 
 
+    // Functions whose bodies only differ in whitespace and comments, in file order. Found when
+    // DetectorConfig::groupExactClones is set, and reported instead of the pairs between them.
+    struct CloneGroup {
+        SmellType type;
+        vector<string_view> functionNames;
+        vector<size_t> functionIndexes;
+
+        CloneGroup(SmellType type, vector<string_view> functionNames, vector<size_t> functionIndexes) {
+            this->type = type;
+            this->functionNames = move(functionNames);
+            this->functionIndexes = move(functionIndexes);
+        }
+    };
+
+    // Lines of one copy of a clone region, in the analyzed file
+    struct RegionLocation {
+        size_t functionIndex;
+        size_t firstLineNumber;
+        size_t lastLineNumber;
+    };
+
+    // A run of tokens that appears in more than one place, and cannot grow to either side
+    // without losing one of them. Found when DetectorConfig::minCloneRegionTokens is set. The
+    // copies never overlap and are in file order; they may be in the same function.
+    struct CloneRegion {
+        SmellType type;
+        size_t tokenCount;
+        vector<RegionLocation> locations;
+
+        CloneRegion(SmellType type, size_t tokenCount, vector<RegionLocation> locations) {
+            this->type = type;
+            this->tokenCount = tokenCount;
+            this->locations = move(locations);
+        }
+    };
+
+    // Callbacks for visitOccurrences(), each called with a reference into the detector's own
+    // lists. Leave a callback empty to skip that smell.
+    struct OccurrenceVisitor {
+        function<void(const LongMethod &occurrence)> longMethod;
+        function<void(const LongParameterList &occurrence)> longParameterList;
+        function<void(Span<uint32_t> functionIndexes)> cloneGroup; // Positions in getFunctions(), in file order
+        function<void(const DuplicatedCode &occurrence)> duplicatedCode;
+        function<void(size_t tokenCount, Span<RegionLocation> locations)> cloneRegion;
+    };
+
+
     /**
      * Initialize all fields and run code smell detection algorithms
      * @param linesFromFile lines of code from the input file
+     * @param config detection settings
+     */
+    explicit CodeSmellDetector(const vector<string_view> &linesFromFile,
+                               const DetectorConfig &config = DetectorConfig());
+
+    /**
+     * Same as above, but only look for code smells in the functions that overlap the changed
+     * lines. Long Method and Long Parameter List are only checked for those functions, clone
+     * groups are only reported if they contain one, and only the pairs with at least one of
+     * them are compared, so the pair scan costs changed * n instead of n * n. The search is
+     * always exact, and the duplicate limit applies to those pairs alone.
+     * @param linesFromFile lines of code from the input file
+     * @param config detection settings
+     * @param changedLines sorted ranges of changed lines that do not overlap
+     */
+    CodeSmellDetector(const vector<string_view> &linesFromFile, const DetectorConfig &config,
+                      const vector<LineRange> &changedLines);
+
+    /**
+     * Wait for a background duplicate scan, if one is still running, and release everything
+     */
+    ~CodeSmellDetector();
+
+    CodeSmellDetector(const CodeSmellDetector &) = delete;
+    CodeSmellDetector &operator=(const CodeSmellDetector &) = delete;
+
+    /**
+     * Get a list of function names extracted from the file. getFunctions() gives the same names
+     * without building a list.
+     * @return vector of views of the function names
+     */
+    vector<string_view> getFunctionNames() const;
+
+    /**
+     * Get the functions extracted from the file, in file order
+     * @return view of the functions
+     */
+    Span<Function> getFunctions() const;
+
+    /**
+     * Does the function overlap the changed lines? Always true without changed lines.
+     * @param functionIndex position of the function in getFunctions()
+     * @return true if the function's smells are reported, false if it only serves as a comparison
+     */
+    bool isChangedFunction(size_t functionIndex) const;
+
+    /**
+     * Get the token shingle set of each function
+     * @return view parallel to getFunctions(), empty unless Duplicated Code is detected with the TOKEN_SHINGLE metric
+     */
+    Span<ShingleSignature> getShingleSignatures() const;
+
+    /**
+     * Get the token IDs of a function, see Tokenizer::lexTokens()
+     * @param functionIndex position of the function in getFunctions()
+     * @return view of its tokens, empty unless Duplicated Code is detected with the TOKEN_SHINGLE
+     * metric, exact clone groups or clone regions
      */
-    explicit CodeSmellDetector(const vector<string> &linesFromFile);
+    Span<uint32_t> getFunctionTokens(size_t functionIndex) const;
 
     /**
-     * Get a list of function names extracted from the file
-     * @return vector of function names
+     * Get the set of distinct characters of a function, see Function::computeCharacterSignature()
+     * @param functionIndex position of the function in getFunctions()
+     * @return the signature the duplicate scan compares, built again if Duplicated Code is not detected
      */
-    vector<string> getFunctionNames() const;
+    CharacterSignature getCharacterSignature(size_t functionIndex) const;
 
     /**
      * Get all occurrences of Long Method code smell
@@ -90,6 +227,45 @@ public:
      */
     vector<DuplicatedCode> getDuplicateCodeOccurrences() const;
 
+    /**
+     * Get all groups of exact clones. Only the first function of a group is compared with the
+     * other functions, so the rest of the group never shows up in getDuplicateCodeOccurrences().
+     * @return vector of CloneGroup objects, ordered by their first function
+     */
+    vector<CloneGroup> getCloneGroupOccurrences() const;
+
+    /**
+     * Get all clone regions, see DetectorConfig::minCloneRegionTokens
+     * @return vector of CloneRegion objects, ordered by their first copy, longer regions first
+     */
+    vector<CloneRegion> getCloneRegionOccurrences() const;
+
+    /**
+     * Same as getLongMethodOccurrences(), without copying them
+     * @return view of the LongMethod objects, valid as long as the detector
+     */
+    Span<LongMethod> viewLongMethodOccurrences() const;
+
+    /**
+     * Same as getLongParameterListOccurrences(), without copying them
+     * @return view of the LongParameterList objects, valid as long as the detector
+     */
+    Span<LongParameterList> viewLongParameterListOccurrences() const;
+
+    /**
+     * Same as getDuplicateCodeOccurrences(), without copying them
+     * @return view of the DuplicatedCode objects, valid as long as the detector
+     */
+    Span<DuplicatedCode> viewDuplicateCodeOccurrences() const;
+
+    /**
+     * Hand every occurrence to the visitor without copying anything: Long Method, Long Parameter
+     * List, exact clone groups, Duplicated Code and then clone regions, each in the order of the
+     * getters above
+     * @param visitor callbacks for the smells of interest
+     */
+    void visitOccurrences(const OccurrenceVisitor &visitor) const;
+
     /**
      * Was Long Method detected?
      * @return true if detected, false if not
@@ -103,11 +279,33 @@ public:
     bool hasLongParameterListSmell() const;
 
     /**
-     * Was Duplicated Code detected?
+     * Was Duplicated Code detected? Exact clones and clone regions count as Duplicated Code.
      * @return true if detected, false if not
      */
     bool hasDuplicateCodeSmell() const;
 
+    /**
+     * Get the number of function pairs whose similarity index was computed. In exact mode this
+     * is n * (n - 1) / 2 less the pruned pairs, in LSH mode usually far less still.
+     * @return number of compared pairs
+     */
+    size_t getComparedPairCount() const;
+
+    /**
+     * Get the number of function pairs that were never compared because their set sizes (or,
+     * for the token metric, their rarest shingles) show they cannot be similar enough. In
+     * exact mode the compared and pruned pairs add up to n * (n - 1) / 2.
+     * @return number of pruned pairs
+     */
+    size_t getPrunedPairCount() const;
+
+    /**
+     * Get the number of duplicated pairs that were found but left out of the occurrences
+     * because of DetectorConfig::duplicateLimit
+     * @return number of omitted pairs, 0 without a limit
+     */
+    size_t getOmittedDuplicateCount() const;
+
     /**
      * Convert SmellType enum to string representation
      * @param type the enum
@@ -115,32 +313,16 @@ public:
      */
     static string smellTypeToString(SmellType type);
 
-private:
-    // Code smell thresholds
-    static const int MAX_LINES_OF_CODE = 15;
-    static const int MAX_PARAMETER_COUNT = 3;
-    static constexpr const double MAX_SIMILARITY_INDEX = 0.75;
-    static const string INCLUDE_DIRECTIVE;
-
-    // Lists to store code smell occurrences
-    vector<LongMethod> longMethodOccurrences;
-    vector<LongParameterList> longParameterListOccurrences;
-    vector<DuplicatedCode> duplicatedCodeOccurrences;
-
-    // Lists to store processed functions
-    vector<Function> functionList;
-    vector<string> functionNames;
-
-    // Store each line of code in functionContent (passed by reference)
-    void extractFunctions(const vector<string> &linesFromFile);
-
-    // Code smell detection helper methods
-    void detectLongMethod();
-    void detectLongParameterList();
-    void detectDuplicatedCode();
+    /**
+     * Hash of everything that decides the results for a given file: the detection settings,
+     * the code smell thresholds and the version of the detection logic
+     * @param config detection settings
+     * @return configuration hash
+     */
+    static uint64_t configurationHash(const DetectorConfig &config);
 
-    /*
-     * Calculates the Jaccard similarity indexes of two strings using character set comparisons.
+    /**
+     * Calculates the Jaccard similarity indexes of two functions using character set comparisons.
      * For example, if the input is two strings "abcd" and "abce", then the compared sets are:
      *
      * - ['a', 'b', 'c', 'd']
@@ -158,13 +340,184 @@ private:
      *
      * - 3 / 5 = 60%
      *
-     * In the implementation, I just keep track of the counts instead of the actual sets since
-     * creating the intersection and union sets is not necessary to calculate the similarity index.
+     * In the implementation, each character set is a 256-bit signature built once per function, so
+     * the intersection and union counts are just the popcounts of the bitwise AND and OR of the two
+     * signatures. The actual sets are never created since only their sizes are needed.
+     * @param firstSignature character set of the first function
+     * @param secondSignature character set of the second function
+     * @return similarity index between 0 and 1
      */
-    static double jaccardSimilarityIndex(const string &firstCodeString, const string &secondCodeString);
+    static double jaccardSimilarityIndex(const CharacterSignature &firstSignature,
+                                         const CharacterSignature &secondSignature);
+
+    /**
+     * Same as above, but the sets hold hashed token k-grams instead of characters. A shingle is
+     * shared only if the same run of tokens appears in both functions, so unrelated functions
+     * written with the same characters no longer look alike.
+     * @param firstShingles sorted shingle set of the first function
+     * @param secondShingles sorted shingle set of the second function
+     * @return similarity index between 0 and 1
+     */
+    static double jaccardSimilarityIndex(Span<uint64_t> firstShingles, Span<uint64_t> secondShingles);
+
+    /**
+     * Find the exact clone group of every function. The body hash only finds the candidates, a
+     * function joins a group once its body equals that of the group's first function.
+     * @param bodyHashes Tokenizer::hashBody of every function
+     * @param sameBody tells whether the bodies of two functions, given by index, are equal
+     * @return index of the first function of each function's group, its own index if it has no earlier clone
+     */
+    static vector<uint32_t> findCloneRepresentatives(const vector<uint64_t> &bodyHashes,
+                                                     const function<bool(uint32_t, uint32_t)> &sameBody);
+
+    /**
+     * Is a function with this many lines of code a Long Method?
+     * @param lineCount number of lines of code in the function
+     * @return true if it is above the threshold, false if not
+     */
+    static bool isLongMethod(size_t lineCount);
+
+    /**
+     * Is a function with this many parameters a Long Parameter List?
+     * @param parameterCount number of parameters of the function
+     * @return true if it is above the threshold, false if not
+     */
+    static bool isLongParameterList(int parameterCount);
+
+    /**
+     * Is a pair of functions with this similarity index Duplicated Code?
+     * @param similarityIndex Jaccard similarity index of the pair
+     * @return true if it is above the threshold, false if not
+     */
+    static bool isDuplicatedCode(double similarityIndex);
+
+private:
+    // Bump whenever a change to the parsing or detection logic can change the results
+    static const uint64_t ANALYSIS_VERSION = 7;
+
+    // Code smell thresholds
+    static const int MAX_LINES_OF_CODE = 15;
+    static const int MAX_PARAMETER_COUNT = 3;
+    static constexpr const double MAX_SIMILARITY_INDEX = 0.75;
+
+    // Bytes of arena to start with per line of the file, roughly what the analysis needs
+    static const size_t ARENA_BYTES_PER_LINE = 64;
+
+    // Functions per side of a tile of the pair space. Two blocks of 256 character signatures
+    // take 16 KB, so a tile's working set stays in the L1/L2 cache while it is scanned.
+    static const size_t PAIR_TILE_SIZE = 256;
+
+    // Below this many functions, comparing every pair is cheaper than building a PrefixFilterIndex
+    static const size_t PREFIX_FILTER_MIN_FUNCTIONS = 64;
+
+    // Functions handed to a worker of the prefix filtered scan at a time
+    static const size_t PROBE_BATCH_SIZE = 64;
+
+    DetectorConfig config;
+    size_t comparedPairCount;
+    size_t prunedPairCount;
+    size_t omittedDuplicateCount;
+
+    // Backs every list below, so it is declared (constructed) first and destroyed last
+    pmr::monotonic_buffer_resource arena;
+
+    // Lists to store code smell occurrences
+    pmr::vector<LongMethod> longMethodOccurrences;
+    pmr::vector<LongParameterList> longParameterListOccurrences;
+    pmr::vector<DuplicatedCode> duplicatedCodeOccurrences;
+
+    // Lists to store processed functions
+    pmr::vector<Function> functionList;
+    pmr::vector<CharacterSignature> characterSignatures; // Parallel to functionList
+    pmr::vector<ShingleSignature> shingleSignatures;     // Parallel to functionList, TOKEN_SHINGLE metric only
+    pmr::vector<uint32_t> setSizes;                      // Parallel to functionList, size of the compared set
+    pmr::vector<uint32_t> scanOrder;                     // Function indexes by ascending set size
+
+    // Parallel to functionList, overlaps the changed lines. Empty when the whole file is analyzed.
+    pmr::vector<bool> changedFunctions;
+
+    // Exact clones, groupExactClones only
+    pmr::vector<uint32_t> cloneRepresentatives; // Parallel to functionList, first function with the same body
+    pmr::vector<uint32_t> cloneGroupMembers;    // Function indexes of every group, one group after another
+    pmr::vector<uint32_t> cloneGroupEnds;       // End of each group in cloneGroupMembers
+
+    // Token IDs of every function, lexed once for the TOKEN_SHINGLE metric, exact clones and clone regions
+    pmr::vector<uint32_t> functionTokens;    // Tokenizer::lexTokens() of each function, one after another
+    pmr::vector<uint32_t> functionTokenEnds; // Parallel to functionList, end of its tokens in functionTokens
+    pmr::vector<uint32_t> tokenLineNumbers;  // Parallel to functionTokens, line of each token, minCloneRegionTokens only
+
+    // Clone regions, minCloneRegionTokens only
+    pmr::vector<RegionLocation> cloneRegionLocations; // Copies of every region, one region after another
+    pmr::vector<uint32_t> cloneRegionEnds;            // End of each region in cloneRegionLocations
+    pmr::vector<uint32_t> cloneRegionTokenCounts;     // Parallel to cloneRegionEnds
+
+    // Runs scanForDuplicates() with backgroundDuplicateScan until a getter needs its results.
+    // Null once it has been waited for, or if the scan ran in the constructor.
+    mutable unique_ptr<ThreadPool> duplicateScan;
+    mutable exception_ptr duplicateScanError; // Thrown by the background scan, rethrown by every getter
+    atomic<bool> duplicateScanCancelled;       // Set when the detector goes away before the scan is done
+
+    // Both public constructors end up here, changedLines is null when the whole file is analyzed
+    CodeSmellDetector(const vector<string_view> &linesFromFile, const DetectorConfig &config,
+                      const vector<LineRange> *changedLines);
+
+    // Build the functions in one pass, marking the changed ones, running the enabled per-function
+    // detectors on them and building the signatures the duplicate scan needs
+    void extractFunctions(const vector<string_view> &linesFromFile, const vector<LineRange> *changedLines);
+
+    // Add an occurrence of a smell a per-function detector found, throws invalid_argument for a smell without a list
+    void recordFunctionSmell(SmellType type, size_t functionIndex, size_t measurement);
+
+    // Look for exact clones, duplicated pairs and clone regions, after the functions are extracted
+    void scanForDuplicates();
+
+    // Block until the background duplicate scan is done, rethrowing what it threw
+    void waitForDuplicateScan() const;
+
+    // Code smell detection helper methods
+    void detectExactClones();
+    void detectCloneRegions();
+    void detectDuplicatedCode();
+    void detectDuplicatedCodeWithLsh(DuplicateCollector &collector);
+
+    // Compare each changed function with every other function, exact search only
+    void detectDuplicatedCodeOfChangedFunctions(DuplicateCollector &collector);
+
+    // The exact scan split into tiles of the upper triangle, shared out among worker threads
+    void detectDuplicatedCodeInTiles(DuplicateCollector &collector, size_t threadCount);
+
+    // Compare every pair (i < j) with i in the row block and j in the column block, where i and j
+    // are positions in scanOrder. Returns the number of pairs compared.
+    size_t scanTile(size_t rowBlock, size_t columnBlock, DuplicateCollector &collector) const;
+
+    // The exact scan for the TOKEN_SHINGLE metric, only comparing the pairs a PrefixFilterIndex lets through
+    void detectDuplicatedCodeWithPrefixFilter(DuplicateCollector &collector, size_t threadCount);
+
+    // Compare the functions at positions [firstPosition, lastPosition) of scanOrder with their
+    // candidates from the index. Returns the number of pairs compared.
+    size_t probeFunctions(const PrefixFilterIndex &index, size_t firstPosition, size_t lastPosition,
+                          PrefixFilterIndex::Probe &probe, DuplicateCollector &collector) const;
+
+    // Sort the functions into scanOrder, smallest set first, leaving out all but the first of each clone group
+    void orderBySetSize();
+
+    // First position after this one in scanOrder whose function is too large to be similar enough
+    size_t pairScanEnd(size_t position) const;
+
+    // Can two functions with these set sizes be similar enough to be Duplicated Code?
+    bool sizesMayBeDuplicated(size_t firstIndex, size_t secondIndex) const;
+
+    // Count the pair as compared or pruned, and hand it to the collector if it is similar enough
+    void compareFunctions(size_t firstIndex, size_t secondIndex, DuplicateCollector &collector);
+
+    // Hand the pair to the collector if it is similar enough, the indexes may come in either order
+    void comparePair(size_t firstIndex, size_t secondIndex, DuplicateCollector &collector) const;
+
+    // Turn the pairs the collector kept into occurrences
+    void recordDuplicates(const DuplicateCollector &collector);
 
-    // Helper for filling the character set
-    static void fillCharSet(unordered_set<char> &charSet, const string &codeString);
+    // Similarity index of two functions under the configured metric
+    double similarityIndex(size_t firstIndex, size_t secondIndex) const;
 };
 
 
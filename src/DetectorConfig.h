@@ -0,0 +1,79 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_DETECTORCONFIG_H
+#define CODESMELLDETECTOR_DETECTORCONFIG_H
+
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * Tunable settings for CodeSmellDetector. The defaults reproduce the original behavior.
+ */
+struct DetectorConfig {
+    enum DuplicateSearch {
+        EXACT, // Compare every pair of functions
+        LSH    // Only compare pairs that share a MinHash band bucket
+    };
+
+    enum DuplicateLimitScope {
+        ALL_PAIRS,   // Keep the most similar pairs of the whole file
+        PER_FUNCTION // Keep the most similar pairs of each function
+    };
+
+    enum SimilarityMetric {
+        CHARACTER,    // Jaccard index of the sets of distinct characters
+        TOKEN_SHINGLE // Jaccard index of the sets of hashed token k-grams
+    };
+
+    // Bit (1 << CodeSmellDetector::SmellType) of each code smell to look for, see DetectorRegistry.
+    // A smell left out costs nothing: its detector and the stages only it needs never run.
+    unsigned enabledSmells = ~0u;
+
+    DuplicateSearch duplicateSearch = EXACT;
+    SimilarityMetric similarityMetric = CHARACTER;
+
+    // Number of consecutive tokens per shingle for the TOKEN_SHINGLE metric
+    size_t shingleSize = 5;
+
+    // Compare tokens with every identifier and literal replaced by its kind, so code that only
+    // differs in names and constants (Type-2 clones) still matches. Applies to the TOKEN_SHINGLE
+    // metric and to clone regions; exact clone groups stay exact.
+    bool normalizeIdentifiers = false;
+
+    // A pair becomes an LSH candidate if all rows of at least one band agree. The chance of that
+    // for a pair with similarity s is 1 - (1 - s^rows)^bands, about 99.6% at the 0.75 threshold.
+    size_t lshBandCount = 20;
+    size_t lshRowsPerBand = 5;
+
+    // Report functions whose bodies only differ in whitespace and comments as one group of
+    // exact clones, and only compare the first function of each group with the others
+    bool groupExactClones = false;
+
+    // Also report every run of at least this many tokens that appears more than once, within a
+    // function or across functions, with the lines of each copy. Copies may differ in whitespace
+    // and comments. 0 turns the search off.
+    size_t minCloneRegionTokens = 0;
+
+    // Keep only this many of the most similar duplicated pairs (per function with PER_FUNCTION)
+    // and just count the rest. 0 keeps every pair.
+    size_t duplicateLimit = 0;
+    DuplicateLimitScope duplicateLimitScope = ALL_PAIRS;
+
+    // Worker threads for the EXACT all-pairs scan, 0 selects all cores. Only changes how fast
+    // the results come, never what they are.
+    size_t pairScanThreadCount = 1;
+
+    // Skip pairs whose set sizes (and for TOKEN_SHINGLE, rarest shingles) rule out enough
+    // similarity without comparing them. Like the thread count, never changes the results.
+    bool pruneCandidatePairs = true;
+
+    // Let the CodeSmellDetector constructor return once the file is parsed and run the duplicate
+    // scan on a thread of its own, until its results are asked for. Never changes the results either.
+    bool backgroundDuplicateScan = false;
+};
+
+
+#endif //CODESMELLDETECTOR_DETECTORCONFIG_H
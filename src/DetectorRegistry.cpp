@@ -0,0 +1,78 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "DetectorRegistry.h"
+#include <stdexcept>
+
+using namespace std;
+
+const vector<DetectorRegistry::Detector> &DetectorRegistry::getDetectors() {
+    static const vector<Detector> detectors = {
+            {CodeSmellDetector::LONG_METHOD,         "long-method",         PER_FUNCTION, checkLongMethod},
+            {CodeSmellDetector::LONG_PARAMETER_LIST, "long-parameter-list", PER_FUNCTION, checkLongParameterList},
+            {CodeSmellDetector::DUPLICATED_CODE,     "duplicated-code",     PAIRWISE,     nullptr}
+    };
+    return detectors;
+}
+
+unsigned DetectorRegistry::smellBit(CodeSmellDetector::SmellType type) {
+    return 1u << type;
+}
+
+unsigned DetectorRegistry::allSmells() {
+    unsigned smells = 0;
+    for (const Detector &detector : getDetectors()) {
+        smells |= smellBit(detector.type);
+    }
+    return smells;
+}
+
+bool DetectorRegistry::isEnabled(const DetectorConfig &config, CodeSmellDetector::SmellType type) {
+    return (config.enabledSmells & smellBit(type)) != 0;
+}
+
+vector<const DetectorRegistry::Detector *> DetectorRegistry::getFunctionDetectors(const DetectorConfig &config) {
+    vector<const Detector *> functionDetectors;
+    for (const Detector &detector : getDetectors()) {
+        if (detector.kind == PER_FUNCTION && isEnabled(config, detector.type)) {
+            functionDetectors.push_back(&detector);
+        }
+    }
+    return functionDetectors;
+}
+
+unsigned DetectorRegistry::parseSmellList(string_view names) {
+    unsigned smells = 0;
+    while (!names.empty()) {
+        size_t commaIndex = names.find(',');
+        string_view name = names.substr(0, commaIndex);
+        names = commaIndex == string_view::npos ? string_view() : names.substr(commaIndex + 1);
+
+        const Detector *found = nullptr;
+        for (const Detector &detector : getDetectors()) {
+            if (name == detector.name) {
+                found = &detector;
+            }
+        }
+        if (found == nullptr) {
+            throw invalid_argument("unknown code smell: [" + string(name) + "]");
+        }
+        smells |= smellBit(found->type);
+    }
+
+    if (smells == 0) {
+        throw invalid_argument("no code smell to detect");
+    }
+    return smells;
+}
+
+bool DetectorRegistry::checkLongMethod(const Function &function, size_t &lineCount) {
+    lineCount = function.getNumberOfLinesOfCode();
+    return CodeSmellDetector::isLongMethod(lineCount);
+}
+
+bool DetectorRegistry::checkLongParameterList(const Function &function, size_t &parameterCount) {
+    parameterCount = function.getNumberOfParameters();
+    return CodeSmellDetector::isLongParameterList(function.getNumberOfParameters());
+}
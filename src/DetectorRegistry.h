@@ -0,0 +1,98 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_DETECTORREGISTRY_H
+#define CODESMELLDETECTOR_DETECTORREGISTRY_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "CodeSmellDetector.h"
+#include "DetectorConfig.h"
+#include "Function.h"
+
+using namespace std;
+
+/**
+ * The detectors CodeSmellDetector can run, one per code smell. Per-function detectors look at
+ * one function at a time, so they all run in a single pass, on each function right after the
+ * parser builds it and while its data is still in the cache. Pairwise detectors look at pairs of
+ * functions and share the candidate pairs of the duplicate scan (tiles, prefix filter, LSH or
+ * changed functions). DetectorConfig::enabledSmells decides which detectors run; a disabled
+ * detector is never called, and the stages only it needs (signatures, the pair scan) are skipped.
+ *
+ * The table decides which detectors run, but the results are still kept per smell. Besides a check
+ * function and an entry in the table in DetectorRegistry.cpp, a new per-function smell needs an
+ * occurrence list filled by CodeSmellDetector::recordFunctionSmell(), a function list in
+ * AnalysisSummary (built by IncrementalAnalyzer::getSummary() too and stored by AnalysisCache)
+ * and its output in main.cpp and ReportWriter.
+ */
+class DetectorRegistry {
+public:
+    enum Kind {
+        PER_FUNCTION, // Looks at one function
+        PAIRWISE      // Looks at pairs of functions
+    };
+
+    // Look at one function. Returns true if it has the smell and sets the measurement that shows
+    // it (lines of code, parameters).
+    typedef bool (*FunctionCheck)(const Function &function, size_t &measurement);
+
+    struct Detector {
+        CodeSmellDetector::SmellType type;
+        const char *name;    // Name for --smells
+        Kind kind;
+        FunctionCheck check; // Per-function detectors only, null for pairwise ones
+    };
+
+    /**
+     * Get every detector, in the order their smells are reported
+     * @return the detector table
+     */
+    static const vector<Detector> &getDetectors();
+
+    /**
+     * Get the bit of a smell in DetectorConfig::enabledSmells
+     * @param type the smell
+     * @return bit mask with only that smell
+     */
+    static unsigned smellBit(CodeSmellDetector::SmellType type);
+
+    /**
+     * Get the enabledSmells value with every known smell
+     * @return bit mask of all smells
+     */
+    static unsigned allSmells();
+
+    /**
+     * Does the configuration look for a smell?
+     * @param config detection settings
+     * @param type the smell
+     * @return true if its detector runs, false if not
+     */
+    static bool isEnabled(const DetectorConfig &config, CodeSmellDetector::SmellType type);
+
+    /**
+     * Get the enabled per-function detectors
+     * @param config detection settings
+     * @return detectors to run on each function, in table order
+     */
+    static vector<const Detector *> getFunctionDetectors(const DetectorConfig &config);
+
+    /**
+     * Parse a comma separated list of detector names, such as "long-method,duplicated-code"
+     * @param names the list
+     * @return enabledSmells value with the listed smells
+     * @throws invalid_argument if a name is unknown or the list is empty
+     */
+    static unsigned parseSmellList(string_view names);
+
+private:
+    // Checks of the per-function detectors
+    static bool checkLongMethod(const Function &function, size_t &lineCount);
+    static bool checkLongParameterList(const Function &function, size_t &parameterCount);
+};
+
+
+#endif //CODESMELLDETECTOR_DETECTORREGISTRY_H
@@ -0,0 +1,110 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "DuplicateCollector.h"
+#include <algorithm>
+
+using namespace std;
+
+DuplicateCollector::DuplicateCollector(const DetectorConfig &config, size_t functionCount) {
+    this->limit = config.duplicateLimit;
+    this->scope = config.duplicateLimitScope;
+    this->functionCount = functionCount;
+    this->offeredCount = 0;
+
+    if (limit > 0 && scope == DetectorConfig::PER_FUNCTION) {
+        functionHeaps.resize(functionCount);
+    }
+}
+
+void DuplicateCollector::add(const Hit &hit) {
+    offeredCount++;
+
+    if (limit == 0) {
+        hits.push_back(hit);
+    } else if (scope == DetectorConfig::PER_FUNCTION) {
+        offer(functionHeaps[hit.firstIndex], hit);
+        offer(functionHeaps[hit.secondIndex], hit);
+    } else {
+        offer(hits, hit);
+    }
+}
+
+void DuplicateCollector::merge(const DuplicateCollector &other) {
+    // A pair among the best of all pairs is also among the best of the pairs the other saw,
+    // so offering only what it kept loses nothing
+    vector<Hit> otherHits = other.keptHits();
+    for (const Hit &hit : otherHits) {
+        add(hit);
+    }
+    offeredCount += other.offeredCount - otherHits.size();
+}
+
+vector<DuplicateCollector::Hit> DuplicateCollector::getHits() const {
+    return keptHits();
+}
+
+size_t DuplicateCollector::getDroppedCount() const {
+    return limit == 0 ? 0 : offeredCount - keptHits().size();
+}
+
+bool DuplicateCollector::isBetter(const Hit &first, const Hit &second) {
+    if (first.similarityIndex != second.similarityIndex) {
+        return first.similarityIndex > second.similarityIndex;
+    }
+    return first.firstIndex != second.firstIndex ? first.firstIndex < second.firstIndex
+                                                 : first.secondIndex < second.secondIndex;
+}
+
+void DuplicateCollector::offer(vector<Hit> &heap, const Hit &hit) const {
+    // Ordered by isBetter, the front of the heap is the worst pair kept so far
+    if (heap.size() < limit) {
+        heap.push_back(hit);
+        push_heap(heap.begin(), heap.end(), isBetter);
+    } else if (isBetter(hit, heap.front())) {
+        pop_heap(heap.begin(), heap.end(), isBetter);
+        heap.back() = hit;
+        push_heap(heap.begin(), heap.end(), isBetter);
+    }
+}
+
+vector<DuplicateCollector::Hit> DuplicateCollector::keptHits() const {
+    vector<Hit> kept = hits;
+    for (const vector<Hit> &heap : functionHeaps) {
+        kept.insert(kept.end(), heap.begin(), heap.end());
+    }
+
+    auto inFileOrder = [](const Hit &first, const Hit &second) {
+        return first.firstIndex != second.firstIndex ? first.firstIndex < second.firstIndex
+                                                     : first.secondIndex < second.secondIndex;
+    };
+    auto samePair = [](const Hit &first, const Hit &second) {
+        return first.firstIndex == second.firstIndex && first.secondIndex == second.secondIndex;
+    };
+
+    // Scans that visit the pairs out of file order can keep millions of them, so sort in linear
+    // time: by the second function, then stably by the first
+    if (!is_sorted(kept.begin(), kept.end(), inFileOrder)) {
+        vector<Hit> bySecondIndex(kept.size());
+        countingSort(kept, bySecondIndex, &Hit::secondIndex);
+        countingSort(bySecondIndex, kept, &Hit::firstIndex);
+    }
+
+    // A pair kept by both of its functions shows up twice
+    kept.erase(unique(kept.begin(), kept.end(), samePair), kept.end());
+    return kept;
+}
+
+void DuplicateCollector::countingSort(const vector<Hit> &from, vector<Hit> &to, uint32_t Hit::*key) const {
+    vector<size_t> offsets(functionCount + 1, 0);
+    for (const Hit &hit : from) {
+        offsets[hit.*key + 1]++;
+    }
+    for (size_t i = 1; i < offsets.size(); i++) {
+        offsets[i] += offsets[i - 1];
+    }
+    for (const Hit &hit : from) {
+        to[offsets[hit.*key]++] = hit;
+    }
+}
@@ -0,0 +1,84 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_DUPLICATECOLLECTOR_H
+#define CODESMELLDETECTOR_DUPLICATECOLLECTOR_H
+
+#include <cstdint>
+#include <vector>
+#include "DetectorConfig.h"
+
+using namespace std;
+
+/**
+ * Collects the duplicated pairs found by a scan. Without a limit it keeps all of them. With a
+ * limit K it keeps only the K most similar pairs overall, or every pair that is among the K
+ * most similar pairs of either of its functions, in fixed size min-heaps. The rest are only
+ * counted, so memory no longer depends on how many pairs match. Ties in similarity go to the
+ * pair that comes first in file order, which makes the kept set independent of the order
+ * the pairs arrive in: scans split across threads keep exactly what a single thread would.
+ */
+class DuplicateCollector {
+public:
+    struct Hit {
+        uint32_t firstIndex;
+        uint32_t secondIndex;
+        double similarityIndex;
+    };
+
+    /**
+     * Initialize an empty collector
+     * @param config detection settings, for the limit and its scope
+     * @param functionCount number of functions the pairs are drawn from
+     */
+    DuplicateCollector(const DetectorConfig &config, size_t functionCount);
+
+    /**
+     * Offer a duplicated pair
+     * @param hit the pair and its similarity
+     */
+    void add(const Hit &hit);
+
+    /**
+     * Offer every pair another collector kept and take over its count of dropped pairs
+     * @param other collector that saw a disjoint set of pairs
+     */
+    void merge(const DuplicateCollector &other);
+
+    /**
+     * Get the kept pairs
+     * @return pairs in file order (by first, then second function)
+     */
+    vector<Hit> getHits() const;
+
+    /**
+     * Get the number of duplicated pairs that were found but not kept
+     * @return dropped pair count
+     */
+    size_t getDroppedCount() const;
+
+private:
+    size_t limit; // 0 keeps every pair
+    size_t functionCount;
+    DetectorConfig::DuplicateLimitScope scope;
+    size_t offeredCount;
+
+    vector<Hit> hits;                 // Every pair, or a min-heap of the best pairs overall
+    vector<vector<Hit>> functionHeaps; // PER_FUNCTION: a min-heap of the best pairs of each function
+
+    // Is the first pair more worth keeping than the second?
+    static bool isBetter(const Hit &first, const Hit &second);
+
+    // Push into a min-heap of at most limit pairs, evicting the worst pair if it is full
+    void offer(vector<Hit> &heap, const Hit &hit) const;
+
+    // Every kept pair once, in file order
+    vector<Hit> keptHits() const;
+
+    // Stable sort of the pairs by one of their function indexes
+    void countingSort(const vector<Hit> &from, vector<Hit> &to, uint32_t Hit::*key) const;
+};
+
+
+#endif //CODESMELLDETECTOR_DUPLICATECOLLECTOR_H
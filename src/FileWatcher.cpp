@@ -0,0 +1,96 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "FileWatcher.h"
+#include "BatchScanner.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <stdexcept>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+using namespace std;
+
+FileWatcher::FileWatcher(const vector<string> &directories) {
+    this->descriptor = inotify_init1(IN_CLOEXEC);
+    if (descriptor < 0) {
+        throw invalid_argument("error starting inotify");
+    }
+
+    for (const string &directory : directories) {
+        // Closing a file after writing it is a save, and so is renaming a finished file into place
+        int watch = inotify_add_watch(descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (watch < 0) {
+            close(descriptor);
+            throw invalid_argument("error watching directory: [" + directory + "]");
+        }
+        watchedDirectories[watch] = directory;
+    }
+}
+
+FileWatcher::~FileWatcher() {
+    close(descriptor);
+}
+
+vector<string> FileWatcher::waitForChanges() {
+    vector<string> changedFiles;
+    while (changedFiles.empty()) {
+        readEvents(-1, changedFiles);
+    }
+    while (readEvents(SETTLE_MILLISECONDS, changedFiles)) {
+    }
+
+    sort(changedFiles.begin(), changedFiles.end());
+    changedFiles.erase(unique(changedFiles.begin(), changedFiles.end()), changedFiles.end());
+    return changedFiles;
+}
+
+bool FileWatcher::readEvents(int timeoutMilliseconds, vector<string> &changedFiles) {
+    pollfd ready = {descriptor, POLLIN, 0};
+    int readyCount = poll(&ready, 1, timeoutMilliseconds);
+    if (readyCount < 0 && errno != EINTR) {
+        throw invalid_argument("error waiting for file changes");
+    }
+    if (readyCount <= 0) {
+        return false;
+    }
+
+    // Room for at least one event with the longest possible name
+    alignas(inotify_event) char buffer[sizeof(inotify_event) + NAME_MAX + 1];
+    ssize_t length = read(descriptor, buffer, sizeof(buffer));
+    if (length < 0) {
+        if (errno == EINTR || errno == EAGAIN) {
+            return false;
+        }
+        throw invalid_argument("error reading file changes");
+    }
+
+    for (ssize_t offset = 0; offset < length;) {
+        const inotify_event *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+        offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+        auto directory = watchedDirectories.find(event->wd);
+        if (directory == watchedDirectories.end() || event->len == 0 || (event->mask & IN_ISDIR)) {
+            continue;
+        }
+
+        string name = event->name;
+        if (!BatchScanner::hasSourceExtension(name)) {
+            continue;
+        }
+
+        // Files given without a directory were watched through "."; report them the way they were given
+        const string &path = directory->second;
+        if (path == ".") {
+            changedFiles.push_back(name);
+        } else if (path.back() == '/') {
+            changedFiles.push_back(path + name);
+        } else {
+            changedFiles.push_back(path + "/" + name);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,57 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_FILEWATCHER_H
+#define CODESMELLDETECTOR_FILEWATCHER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Waits for source files to be saved, using inotify. Directories are watched rather than the
+ * files themselves, because many editors save by writing a new file and renaming it over the
+ * old one, which would silently end a watch on the old file. Subdirectories created after the
+ * watcher started are not watched.
+ */
+class FileWatcher {
+public:
+    /**
+     * Start watching
+     * @param directories directories whose source files to watch
+     * @throws invalid_argument if inotify is not available or a directory cannot be watched
+     */
+    explicit FileWatcher(const vector<string> &directories);
+
+    /**
+     * Stop watching
+     */
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+
+    /**
+     * Block until at least one source file was written or moved into a watched directory. A save
+     * often shows up as several events, so events arriving shortly after the first are included.
+     * @return paths of the changed source files, sorted without duplicates
+     * @throws invalid_argument if reading the events fails
+     */
+    vector<string> waitForChanges();
+
+private:
+    // How long to wait for more events after the first one of a save
+    static const int SETTLE_MILLISECONDS = 5;
+
+    int descriptor;
+    unordered_map<int, string> watchedDirectories; // Watch descriptor to directory path
+
+    // Read the events that are ready, appending the changed source files. Returns false if none were ready in time.
+    bool readEvents(int timeoutMilliseconds, vector<string> &changedFiles);
+};
+
+
+#endif //CODESMELLDETECTOR_FILEWATCHER_H
@@ -4,21 +4,24 @@
 
 #include "Function.h"
 #include <string>
-#include <vector>
-#include <iostream>
-#include <sstream>
+#include <cctype>
 #include <algorithm>
 #include "Parser.h"
 #include <stdexcept>
 
 using namespace std;
 
-Function::Function(const vector<string> &codeLines) {
+Function::Function(Span<string_view> codeLines, size_t firstLineNumber, size_t lastLineNumber) {
+    if (codeLines.empty()) {
+        throw invalid_argument("function at line " + to_string(firstLineNumber) + " has no lines of code");
+    }
+
     this->codeLines = codeLines;
     this->numLinesOfCode = codeLines.size();
+    this->firstLineNumber = firstLineNumber;
+    this->lastLineNumber = lastLineNumber;
     this->name = extractName();
     this->numParameters = extractParameterCount();
-    this->codeString = generateCodeString();
 }
 
 size_t Function::getNumberOfLinesOfCode() const {
@@ -29,44 +32,59 @@ int Function::getNumberOfParameters() const {
     return numParameters;
 }
 
-string Function::getName() const {
+size_t Function::getFirstLineNumber() const {
+    return firstLineNumber;
+}
+
+size_t Function::getLastLineNumber() const {
+    return lastLineNumber;
+}
+
+string_view Function::getName() const {
     return name;
 }
 
-string Function::getCodeString() const {
-    return codeString;
+Span<string_view> Function::getCodeLines() const {
+    return codeLines;
+}
+
+CharacterSignature Function::computeCharacterSignature() const {
+    CharacterSignature signature;
+    for (string_view line : codeLines) {
+        signature.add(line);
+    }
+    return signature;
 }
 
-string Function::extractName() const {
-    const string ampersand = string(1, Parser::AMPERSAND);
-    const string asterisk = string(1, Parser::ASTERISK);
-    string functionHeader = getFunctionHeader();
-    istringstream iss(functionHeader);
+string_view Function::extractName() const {
+    const string_view ampersand(&Parser::AMPERSAND, 1);
+    const string_view asterisk(&Parser::ASTERISK, 1);
+    string_view functionHeader = getFunctionHeader();
+    size_t position = 0;
 
-    string throwawayReturnType;
-    iss >> throwawayReturnType;
+    string_view throwawayReturnType = nextToken(functionHeader, position);
+    (void) throwawayReturnType;
 
-    string next;
-    iss >> next;
+    string_view next = nextToken(functionHeader, position);
     // If function is pointer or reference type, get next token
     if (next == ampersand || next == asterisk) {
-        iss >> next;
+        next = nextToken(functionHeader, position);
     }
 
-    string restOfFunctionHeader = next;
+    string_view restOfFunctionHeader = next;
     return restOfFunctionHeader.substr(0, restOfFunctionHeader.find(Parser::OPENING_PAREN));
 }
 
 int Function::extractParameterCount() const {
     // Get substring between the parentheses
-    string functionHeader = getFunctionHeader();
+    string_view functionHeader = getFunctionHeader();
     size_t leftIndex = functionHeader.find_first_of(Parser::OPENING_PAREN);
     size_t rightIndex = functionHeader.find_last_of(Parser::CLOSING_PAREN);
-    string paramString = functionHeader.substr(leftIndex + 1, rightIndex - leftIndex - 1);
+    string_view paramString = functionHeader.substr(leftIndex + 1, rightIndex - leftIndex - 1);
 
     // If parameter contents is empty
     // or only whitespaces (couldn't find index that isn't a whitespace)
-    if (paramString.empty() || paramString.find_first_not_of(Parser::WHITESPACE) == string::npos) {
+    if (paramString.empty() || paramString.find_first_not_of(Parser::WHITESPACE) == string_view::npos) {
         return 0;
     }
 
@@ -80,16 +98,8 @@ int Function::extractParameterCount() const {
     return paramCount;
 }
 
-string Function::generateCodeString() const {
-    ostringstream ss;
-    for (const string &line : codeLines) {
-        ss << line;
-    }
-    return ss.str();
-}
-
-string Function::getFunctionHeader() const {
-    string firstLine = codeLines[FIRST_LINE];
+string_view Function::getFunctionHeader() const {
+    string_view firstLine = codeLines[FIRST_LINE];
 
     if (numLinesOfCode > 1) {
         return firstLine;
@@ -102,3 +112,16 @@ string Function::getFunctionHeader() const {
         return firstLine.substr(0, closingParenIndex + 1);
     }
 }
+
+string_view Function::nextToken(string_view text, size_t &position) {
+    while (position < text.size() && isspace(static_cast<unsigned char>(text[position]))) {
+        position++;
+    }
+
+    size_t tokenStart = position;
+    while (position < text.size() && !isspace(static_cast<unsigned char>(text[position]))) {
+        position++;
+    }
+
+    return text.substr(tokenStart, position - tokenStart);
+}
@@ -7,21 +7,29 @@
 
 
 #include <string>
-#include <vector>
+#include <string_view>
+#include "CharacterSignature.h"
+#include "Span.h"
 
 using namespace std;
 
 /**
  * Represents a function from a code file. Stores important properties of a function
  * including number of lines of code, number of parameters, and name of the function.
+ * Holds no memory of its own: the lines and the name are views into the source file and
+ * the list of lines lives in the analysis arena of the CodeSmellDetector.
  */
 class Function {
 public:
     /**
-     * Initialize all function properties
+     * Initialize all function properties. The lines are views into the source file, and
+     * both the file and the array of views must outlive the function.
      * @param codeLines lines of code that comprise the function
+     * @param firstLineNumber line of the function header in the file (one based)
+     * @param lastLineNumber line of the closing curly bracket in the file (one based)
+     * @throws invalid_argument if there are no lines of code, the first one must be the header
      */
-    explicit Function(const vector<string> &codeLines);
+    Function(Span<string_view> codeLines, size_t firstLineNumber, size_t lastLineNumber);
 
     /**
      * Get the number of lines of code (LOC) in this function
@@ -35,33 +43,54 @@ public:
      */
     int getNumberOfParameters() const;
 
+    /**
+     * Get the line the function starts on
+     * @return line number of the function header (one based)
+     */
+    size_t getFirstLineNumber() const;
+
+    /**
+     * Get the line the function ends on
+     * @return line number of the closing curly bracket (one based)
+     */
+    size_t getLastLineNumber() const;
+
     /**
      * Get the name of this function
-     * @return name of the function
+     * @return view of the name in the source file
      */
-    string getName() const;
+    string_view getName() const;
 
     /**
-     * Get the code from the body of the function in the form of a string. Mashes
-     * the function into one giant string.
-     * @return string representation of the function code
+     * Get the lines of code that make up the function, without blank and comment lines
+     * @return views of the lines of code
      */
-    string getCodeString() const;
+    Span<string_view> getCodeLines() const;
+
+    /**
+     * Build the set of distinct characters used in the function code. Built on every call,
+     * the CodeSmellDetector keeps the one copy its duplicate scan reads.
+     * @return character signature of the lines of code
+     */
+    CharacterSignature computeCharacterSignature() const;
 
 private:
     static const size_t FIRST_LINE = 0; // Line 1 stored at index 0
 
-    vector<string> codeLines;
-    string name;
+    Span<string_view> codeLines;
+    string_view name;
     size_t numLinesOfCode;
+    size_t firstLineNumber;
+    size_t lastLineNumber;
     int numParameters;
-    string codeString;
 
     // Helper methods for parsing different parts of the function
-    string extractName() const;
+    string_view extractName() const;
     int extractParameterCount() const;
-    string getFunctionHeader() const;
-    string generateCodeString() const;
+    string_view getFunctionHeader() const;
+
+    // Get the next whitespace separated token, advancing position past it (empty if none left)
+    static string_view nextToken(string_view text, size_t &position);
 };
 
 
@@ -0,0 +1,160 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "GlobalFunctionIndex.h"
+#include "CodeSmellDetector.h"
+#include <algorithm>
+
+using namespace std;
+
+GlobalFunctionIndex::GlobalFunctionIndex(const DetectorConfig &config)
+        : minHashIndex(config.lshBandCount, config.lshRowsPerBand) {
+    this->config = config;
+}
+
+void GlobalFunctionIndex::addFile(const string &filename, const AnalysisSummary &summary) {
+    const vector<AnalysisSummary::FunctionMetrics> &fileFunctions = summary.getFunctions();
+    bool useShingles = config.similarityMetric == DetectorConfig::TOKEN_SHINGLE;
+
+    // MinHash signatures are the expensive part, compute them before taking the lock
+    size_t signatureLength = minHashIndex.getSignatureLength();
+    vector<uint32_t> signatures(fileFunctions.size() * signatureLength);
+    vector<uint64_t> shingles;
+    for (size_t i = 0; i < fileFunctions.size(); i++) {
+        uint32_t *signature = signatures.data() + i * signatureLength;
+        if (useShingles) {
+            minHashIndex.computeSignature(fileFunctions[i].shingles, signature);
+            shingles.insert(shingles.end(), fileFunctions[i].shingles.begin(), fileFunctions[i].shingles.end());
+        } else {
+            minHashIndex.computeSignature(fileFunctions[i].characterSignature, signature);
+        }
+    }
+
+    // Under the lock the functions only go into the index and their candidates are collected
+    struct Candidate {
+        uint32_t earlierId;
+        uint32_t laterId;
+        const IndexedFunction *earlier;
+        const IndexedFunction *later;
+    };
+    vector<Candidate> fileCandidates;
+    {
+        lock_guard<mutex> guard(indexLock);
+        uint32_t fileIndex = static_cast<uint32_t>(filenames.size());
+        filenames.push_back(filename);
+        fileShingles.push_back(move(shingles));
+        const uint64_t *nextShingle = fileShingles.back().data();
+
+        vector<uint32_t> candidates;
+        for (size_t i = 0; i < fileFunctions.size(); i++) {
+            const AnalysisSummary::FunctionMetrics &metrics = fileFunctions[i];
+
+            IndexedFunction function;
+            function.fileIndex = fileIndex;
+            function.positionInFile = static_cast<uint32_t>(i);
+            function.firstLineNumber = metrics.firstLineNumber;
+            function.lastLineNumber = metrics.lastLineNumber;
+            function.nameOffset = namePool.size();
+            function.nameLength = metrics.name.size();
+            function.shingles = nextShingle;
+            function.shingleCount = useShingles ? metrics.shingles.size() : 0;
+            function.characterSignature = metrics.characterSignature;
+
+            namePool += metrics.name;
+            nextShingle += function.shingleCount;
+
+            // Look up before adding, so each pair is found once: when its later function arrives
+            uint32_t functionId = static_cast<uint32_t>(functions.size());
+            const uint32_t *signature = signatures.data() + i * signatureLength;
+            minHashIndex.getCandidates(signature, candidates);
+
+            for (uint32_t candidateId : candidates) {
+                if (functions[candidateId].fileIndex == fileIndex) {
+                    continue; // Same file, already reported by CodeSmellDetector
+                }
+                fileCandidates.push_back(Candidate{candidateId, functionId, nullptr, nullptr});
+            }
+
+            functions.push_back(function);
+            minHashIndex.add(functionId, signature);
+        }
+
+        // Elements of a deque stay in place as it grows, so the candidates can be read without the lock
+        for (Candidate &candidate : fileCandidates) {
+            candidate.earlier = &functions[candidate.earlierId];
+            candidate.later = &functions[candidate.laterId];
+        }
+    }
+
+    vector<CrossFileDuplicate> fileDuplicates;
+    for (const Candidate &candidate : fileCandidates) {
+        double pairSimilarityIndex = similarityIndex(*candidate.earlier, *candidate.later);
+        if (CodeSmellDetector::isDuplicatedCode(pairSimilarityIndex)) {
+            fileDuplicates.push_back(CrossFileDuplicate{candidate.earlierId, candidate.laterId, pairSimilarityIndex});
+        }
+    }
+
+    lock_guard<mutex> guard(indexLock);
+    duplicates.insert(duplicates.end(), fileDuplicates.begin(), fileDuplicates.end());
+}
+
+vector<GlobalFunctionIndex::CrossFileDuplicate> GlobalFunctionIndex::getDuplicates() const {
+    lock_guard<mutex> guard(indexLock);
+    vector<CrossFileDuplicate> sortedDuplicates = duplicates;
+
+    for (CrossFileDuplicate &duplicate : sortedDuplicates) {
+        if (comesBefore(duplicate.secondFunction, duplicate.firstFunction)) {
+            swap(duplicate.firstFunction, duplicate.secondFunction);
+        }
+    }
+
+    sort(sortedDuplicates.begin(), sortedDuplicates.end(),
+         [this](const CrossFileDuplicate &first, const CrossFileDuplicate &second) {
+             if (first.firstFunction != second.firstFunction) {
+                 return comesBefore(first.firstFunction, second.firstFunction);
+             }
+             return comesBefore(first.secondFunction, second.secondFunction);
+         });
+    return sortedDuplicates;
+}
+
+string GlobalFunctionIndex::getFilename(uint32_t functionId) const {
+    lock_guard<mutex> guard(indexLock);
+    return filenames[functions[functionId].fileIndex];
+}
+
+string GlobalFunctionIndex::getFunctionName(uint32_t functionId) const {
+    lock_guard<mutex> guard(indexLock);
+    const IndexedFunction &function = functions[functionId];
+    return namePool.substr(function.nameOffset, function.nameLength);
+}
+
+size_t GlobalFunctionIndex::getFirstLineNumber(uint32_t functionId) const {
+    lock_guard<mutex> guard(indexLock);
+    return functions[functionId].firstLineNumber;
+}
+
+size_t GlobalFunctionIndex::getLastLineNumber(uint32_t functionId) const {
+    lock_guard<mutex> guard(indexLock);
+    return functions[functionId].lastLineNumber;
+}
+
+double GlobalFunctionIndex::similarityIndex(const IndexedFunction &first, const IndexedFunction &second) const {
+    if (config.similarityMetric == DetectorConfig::TOKEN_SHINGLE) {
+        return CodeSmellDetector::jaccardSimilarityIndex(Span<uint64_t>(first.shingles, first.shingleCount),
+                                                         Span<uint64_t>(second.shingles, second.shingleCount));
+    }
+    return CodeSmellDetector::jaccardSimilarityIndex(first.characterSignature, second.characterSignature);
+}
+
+bool GlobalFunctionIndex::comesBefore(uint32_t firstFunction, uint32_t secondFunction) const {
+    const IndexedFunction &first = functions[firstFunction];
+    const IndexedFunction &second = functions[secondFunction];
+
+    int pathOrder = filenames[first.fileIndex].compare(filenames[second.fileIndex]);
+    if (pathOrder != 0) {
+        return pathOrder < 0;
+    }
+    return first.positionInFile < second.positionInFile;
+}
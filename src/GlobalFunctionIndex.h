@@ -0,0 +1,121 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_GLOBALFUNCTIONINDEX_H
+#define CODESMELLDETECTOR_GLOBALFUNCTIONINDEX_H
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "AnalysisSummary.h"
+#include "CharacterSignature.h"
+#include "DetectorConfig.h"
+#include "MinHashIndex.h"
+
+using namespace std;
+
+/**
+ * Repository-wide index of function signatures for finding Duplicated Code across files.
+ * Files are added one at a time as they are analyzed; each new function is looked up in a
+ * MinHash LSH index of all functions added so far, and the candidates from other files are
+ * checked with the exact similarity metric. Only names and similarity signatures are kept
+ * (no code), so memory grows by a few dozen bytes per function plus its shingle set under
+ * the token metric. Pairs within one file are left to CodeSmellDetector. Safe to add files
+ * from several threads at once; the results do not depend on the order files are added in.
+ */
+class GlobalFunctionIndex {
+public:
+    struct CrossFileDuplicate {
+        uint32_t firstFunction;  // Function ids, see getFilename() and getFunctionName()
+        uint32_t secondFunction;
+        double similarityIndex;
+    };
+
+    /**
+     * Initialize an empty index
+     * @param config similarity metric and LSH band settings to use, the candidate search is
+     *               always LSH since comparing every pair does not scale past one file
+     */
+    explicit GlobalFunctionIndex(const DetectorConfig &config);
+
+    /**
+     * Add the functions of one file and record the duplicates they form with earlier files
+     * @param filename path of the file
+     * @param summary analysis results of the file
+     */
+    void addFile(const string &filename, const AnalysisSummary &summary);
+
+    /**
+     * Get all duplicated pairs found across files so far, sorted by the path and position of
+     * the first function, then of the second. The first function's file sorts before the
+     * second's.
+     * @return vector of CrossFileDuplicate objects
+     */
+    vector<CrossFileDuplicate> getDuplicates() const;
+
+    /**
+     * Get the path of the file a function belongs to
+     * @param functionId id from a CrossFileDuplicate
+     * @return file path
+     */
+    string getFilename(uint32_t functionId) const;
+
+    /**
+     * Get the name of a function
+     * @param functionId id from a CrossFileDuplicate
+     * @return function name
+     */
+    string getFunctionName(uint32_t functionId) const;
+
+    /**
+     * Get the line a function starts on
+     * @param functionId id from a CrossFileDuplicate
+     * @return line number of the function header (one based)
+     */
+    size_t getFirstLineNumber(uint32_t functionId) const;
+
+    /**
+     * Get the line a function ends on
+     * @param functionId id from a CrossFileDuplicate
+     * @return line number of the closing curly bracket (one based)
+     */
+    size_t getLastLineNumber(uint32_t functionId) const;
+
+private:
+    // Everything kept per function; names live in a shared pool, shingles in the pool of their file
+    struct IndexedFunction {
+        uint32_t fileIndex;
+        uint32_t positionInFile;
+        size_t firstLineNumber;
+        size_t lastLineNumber;
+        size_t nameOffset;
+        size_t nameLength;
+        const uint64_t *shingles;
+        size_t shingleCount;
+        CharacterSignature characterSignature;
+    };
+
+    DetectorConfig config;
+    MinHashIndex minHashIndex;
+
+    // Functions and shingle pools never move once added, so candidates are verified without the lock
+    mutable mutex indexLock;
+    vector<string> filenames;
+    deque<IndexedFunction> functions;
+    string namePool;
+    deque<vector<uint64_t>> fileShingles; // One pool per file, never resized after it is added
+    vector<CrossFileDuplicate> duplicates;
+
+    // Similarity index of two indexed functions under the configured metric
+    double similarityIndex(const IndexedFunction &first, const IndexedFunction &second) const;
+
+    // Does the first function sort before the second (by path, then position)?
+    bool comesBefore(uint32_t firstFunction, uint32_t secondFunction) const;
+};
+
+
+#endif //CODESMELLDETECTOR_GLOBALFUNCTIONINDEX_H
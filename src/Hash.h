@@ -0,0 +1,68 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_HASH_H
+#define CODESMELLDETECTOR_HASH_H
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+using namespace std;
+
+/**
+ * Small, fast non-cryptographic hash helpers shared by the similarity engines.
+ */
+class Hash {
+public:
+    /**
+     * Scramble a 64-bit value so every input bit affects every output bit (splitmix64 finalizer)
+     * @param value value to mix
+     * @return mixed value
+     */
+    static uint64_t mix(uint64_t value) {
+        value ^= value >> 30;
+        value *= 0xbf58476d1ce4e5b9ULL;
+        value ^= value >> 27;
+        value *= 0x94d049bb133111ebULL;
+        value ^= value >> 31;
+        return value;
+    }
+
+    /**
+     * Fold a value into a running hash
+     * @param seed running hash
+     * @param value value to add
+     * @return combined hash
+     */
+    static uint64_t combine(uint64_t seed, uint64_t value) {
+        return mix(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+    }
+
+    /**
+     * Hash a block of bytes, eight at a time
+     * @param bytes the bytes
+     * @param seed starting value, different seeds give independent hashes
+     * @return hash of the bytes and their count
+     */
+    static uint64_t bytes(string_view bytes, uint64_t seed = 0) {
+        uint64_t hash = mix(seed ^ bytes.size());
+        size_t index = 0;
+        for (; index + sizeof(uint64_t) <= bytes.size(); index += sizeof(uint64_t)) {
+            uint64_t word;
+            memcpy(&word, bytes.data() + index, sizeof(word));
+            hash = mix(hash ^ word);
+        }
+
+        if (index < bytes.size()) {
+            uint64_t tail = 0;
+            memcpy(&tail, bytes.data() + index, bytes.size() - index);
+            hash = mix(hash ^ tail);
+        }
+        return hash;
+    }
+};
+
+
+#endif //CODESMELLDETECTOR_HASH_H
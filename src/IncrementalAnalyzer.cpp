@@ -0,0 +1,303 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "IncrementalAnalyzer.h"
+#include "CodeSmellDetector.h"
+#include "DetectorRegistry.h"
+#include "DuplicateCollector.h"
+#include "Function.h"
+#include "Hash.h"
+#include "Parser.h"
+#include "PhaseStats.h"
+#include "ShingleSignature.h"
+#include "Tokenizer.h"
+#include <algorithm>
+#include <memory_resource>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+
+using namespace std;
+
+IncrementalAnalyzer::IncrementalAnalyzer(const DetectorConfig &config) {
+    this->config = config;
+    this->config.duplicateSearch = DetectorConfig::EXACT;
+    // Clone regions span functions, so they cannot be patched one function at a time
+    this->config.minCloneRegionTokens = 0;
+    this->detectsDuplicates = DetectorRegistry::isEnabled(config, CodeSmellDetector::DUPLICATED_CODE);
+    if (!detectsDuplicates) {
+        // Clone groups are Duplicated Code too
+        this->config.groupExactClones = false;
+    }
+    this->changedFunctionCount = 0;
+    this->comparedPairCount = 0;
+}
+
+void IncrementalAnalyzer::update(const vector<string_view> &linesFromFile) {
+    if (functions.empty()) {
+        analyzeFromScratch(linesFromFile);
+        return;
+    }
+
+    // Where each function is and its lines of code; Function objects are only built for changed functions
+    struct FoundFunction {
+        size_t firstLineNumber;
+        size_t lastLineNumber;
+        Span<string_view> codeLines;
+        Span<string_view> sourceLines; // Lexed, comment lines included
+    };
+
+    pmr::monotonic_buffer_resource arena;
+    vector<FoundFunction> found;
+    {
+        PHASE_SCOPE(PARSE);
+        PHASE_ITEMS(PARSE, linesFromFile.size());
+        Parser parser(linesFromFile);
+        parser.forEachFunction([&found, &parser, &arena](size_t firstLineNumber, size_t lastLineNumber) {
+            Span<string_view> codeLines = parser.getFunctionContent(firstLineNumber, lastLineNumber, &arena);
+            found.push_back(FoundFunction{firstLineNumber, lastLineNumber, codeLines,
+                                          parser.getFunctionSource(firstLineNumber, lastLineNumber)});
+        });
+    }
+
+    // Functions of the previous version by the hash of their code, earliest last so it is matched first
+    unordered_map<uint64_t, vector<uint32_t>> previousByHash;
+    for (size_t i = functions.size(); i-- > 0;) {
+        previousByHash[contentHashes[i]].push_back(static_cast<uint32_t>(i));
+    }
+
+    vector<AnalysisSummary::FunctionMetrics> updatedFunctions(found.size());
+    vector<uint64_t> updatedContentHashes(found.size());
+    vector<uint64_t> updatedBodyHashes(config.groupExactClones ? found.size() : 0);
+    vector<vector<uint32_t>> updatedBodies(config.groupExactClones ? found.size() : 0);
+    vector<uint32_t> updatedIndexes(functions.size(), UNMATCHED); // Previous index to current index
+    vector<bool> changed(found.size(), false);
+    vector<uint32_t> changedFunctions;
+    vector<uint32_t> tokens;
+    vector<uint32_t> tokenLines;
+
+    {
+        PHASE_SCOPE(CONSTRUCT_FUNCTIONS);
+        for (size_t i = 0; i < found.size(); i++) {
+            const FoundFunction &foundFunction = found[i];
+            AnalysisSummary::FunctionMetrics &metrics = updatedFunctions[i];
+            updatedContentHashes[i] = hashCodeLines(foundFunction.codeLines);
+
+            auto previous = previousByHash.find(updatedContentHashes[i]);
+            if (previous != previousByHash.end() && !previous->second.empty()) {
+                // Same code, only its position in the file may have moved
+                uint32_t previousIndex = previous->second.back();
+                previous->second.pop_back();
+                updatedIndexes[previousIndex] = static_cast<uint32_t>(i);
+                metrics = move(functions[previousIndex]);
+                if (config.groupExactClones) {
+                    updatedBodyHashes[i] = bodyHashes[previousIndex];
+                    updatedBodies[i] = move(bodies[previousIndex]);
+                }
+            } else {
+                Function function(foundFunction.codeLines, foundFunction.firstLineNumber,
+                                  foundFunction.lastLineNumber);
+                metrics.name = string(function.getName());
+                metrics.lineCount = function.getNumberOfLinesOfCode();
+                metrics.parameterCount = function.getNumberOfParameters();
+                metrics.characterSignature = function.computeCharacterSignature();
+                bool buildsShingles = detectsDuplicates && config.similarityMetric == DetectorConfig::TOKEN_SHINGLE;
+                if (buildsShingles || config.groupExactClones) {
+                    tokens.clear();
+                    tokenLines.clear();
+                    Tokenizer::lexTokens(foundFunction.sourceLines, tokens, tokenLines);
+                }
+                if (buildsShingles) {
+                    ShingleSignature shingleSignature(tokens, config.shingleSize, config.normalizeIdentifiers);
+                    Span<uint64_t> shingles = shingleSignature.getShingles();
+                    metrics.shingles.assign(shingles.begin(), shingles.end());
+                }
+                if (config.groupExactClones) {
+                    Span<uint32_t> body = Tokenizer::getBody(tokens);
+                    updatedBodyHashes[i] = Tokenizer::hashBody(tokens);
+                    updatedBodies[i].assign(body.begin(), body.end());
+                }
+                changed[i] = true;
+                changedFunctions.push_back(static_cast<uint32_t>(i));
+            }
+            metrics.firstLineNumber = foundFunction.firstLineNumber;
+            metrics.lastLineNumber = foundFunction.lastLineNumber;
+        }
+        PHASE_ITEMS(CONSTRUCT_FUNCTIONS, changedFunctions.size());
+    }
+
+    PHASE_SCOPE(DETECT_DUPLICATED_CODE);
+
+    // Pairs of unchanged functions are still duplicated, only their indexes may have moved
+    vector<AnalysisSummary::DuplicatePair> updatedPairs;
+    for (const AnalysisSummary::DuplicatePair &pair : duplicatePairs) {
+        uint32_t firstFunction = updatedIndexes[pair.firstFunction];
+        uint32_t secondFunction = updatedIndexes[pair.secondFunction];
+        if (firstFunction != UNMATCHED && secondFunction != UNMATCHED) {
+            updatedPairs.push_back(AnalysisSummary::DuplicatePair{min(firstFunction, secondFunction),
+                                                                  max(firstFunction, secondFunction),
+                                                                  pair.similarityIndex});
+        }
+    }
+
+    // Every pair with a changed function is new, pairs of two changed functions are compared once
+    size_t pairCount = 0;
+    if (detectsDuplicates) {
+        for (uint32_t changedFunction : changedFunctions) {
+            for (size_t other = 0; other < updatedFunctions.size(); other++) {
+                if (other == changedFunction || (changed[other] && other < changedFunction)) {
+                    continue;
+                }
+
+                pairCount++;
+                double pairSimilarityIndex = similarityIndex(updatedFunctions[changedFunction],
+                                                             updatedFunctions[other]);
+                if (CodeSmellDetector::isDuplicatedCode(pairSimilarityIndex)) {
+                    updatedPairs.push_back(AnalysisSummary::DuplicatePair{
+                            static_cast<uint32_t>(min<size_t>(changedFunction, other)),
+                            static_cast<uint32_t>(max<size_t>(changedFunction, other)), pairSimilarityIndex});
+                }
+            }
+        }
+    }
+    PHASE_ITEMS(DETECT_DUPLICATED_CODE, pairCount);
+
+    functions = move(updatedFunctions);
+    contentHashes = move(updatedContentHashes);
+    bodyHashes = move(updatedBodyHashes);
+    bodies = move(updatedBodies);
+    duplicatePairs = move(updatedPairs);
+    changedFunctionCount = changedFunctions.size();
+    comparedPairCount = pairCount;
+}
+
+void IncrementalAnalyzer::analyzeFromScratch(const vector<string_view> &linesFromFile) {
+    // Every pair and no groups, those are only applied when the summary is built
+    DetectorConfig scanConfig = config;
+    scanConfig.duplicateLimit = 0;
+    scanConfig.groupExactClones = false;
+    CodeSmellDetector detector(linesFromFile, scanConfig);
+    AnalysisSummary summary(detector);
+
+    Span<Function> detectorFunctions = detector.getFunctions();
+    Parser parser(linesFromFile);
+    vector<uint64_t> updatedContentHashes;
+    vector<uint64_t> updatedBodyHashes;
+    vector<vector<uint32_t>> updatedBodies;
+    vector<uint32_t> lexedTokens;
+    vector<uint32_t> lexedLines;
+    for (size_t i = 0; i < detectorFunctions.size(); i++) {
+        const Function &function = detectorFunctions[i];
+        updatedContentHashes.push_back(hashCodeLines(function.getCodeLines()));
+        if (config.groupExactClones) {
+            // The detector only lexed the functions if the token metric needed them, groups are off in scanConfig
+            Span<uint32_t> tokens = detector.getFunctionTokens(i);
+            if (tokens.empty()) {
+                lexedTokens.clear();
+                lexedLines.clear();
+                Tokenizer::lexTokens(parser.getFunctionSource(function.getFirstLineNumber(),
+                                                              function.getLastLineNumber()),
+                                     lexedTokens, lexedLines);
+                tokens = lexedTokens;
+            }
+            Span<uint32_t> body = Tokenizer::getBody(tokens);
+            updatedBodyHashes.push_back(Tokenizer::hashBody(tokens));
+            updatedBodies.emplace_back(body.begin(), body.end());
+        }
+    }
+
+    functions = summary.getFunctions();
+    contentHashes = move(updatedContentHashes);
+    bodyHashes = move(updatedBodyHashes);
+    bodies = move(updatedBodies);
+    duplicatePairs = summary.getDuplicatePairs();
+    changedFunctionCount = functions.size();
+    comparedPairCount = summary.getComparedPairCount();
+}
+
+AnalysisSummary IncrementalAnalyzer::getSummary() const {
+    // Each per-function smell has a list of its own in the summary, see DetectorRegistry
+    bool detectsLongMethod = DetectorRegistry::isEnabled(config, CodeSmellDetector::LONG_METHOD);
+    bool detectsLongParameterList = DetectorRegistry::isEnabled(config, CodeSmellDetector::LONG_PARAMETER_LIST);
+    vector<uint32_t> longMethodFunctions;
+    vector<uint32_t> longParameterListFunctions;
+    for (size_t i = 0; i < functions.size(); i++) {
+        if (detectsLongMethod && CodeSmellDetector::isLongMethod(functions[i].lineCount)) {
+            longMethodFunctions.push_back(static_cast<uint32_t>(i));
+        }
+        if (detectsLongParameterList && CodeSmellDetector::isLongParameterList(functions[i].parameterCount)) {
+            longParameterListFunctions.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    // Groups of two or more, in the order of their first function
+    vector<uint32_t> representatives = cloneRepresentatives();
+    vector<vector<uint32_t>> cloneGroups;
+    if (config.groupExactClones) {
+        vector<vector<uint32_t>> groups(functions.size());
+        for (size_t i = 0; i < functions.size(); i++) {
+            groups[representatives[i]].push_back(static_cast<uint32_t>(i));
+        }
+        for (vector<uint32_t> &group : groups) {
+            if (group.size() > 1) {
+                cloneGroups.push_back(move(group));
+            }
+        }
+    }
+
+    // Only the first function of a clone group takes part in the pairs, as in CodeSmellDetector.
+    // The collector also puts the pairs back in file order.
+    DuplicateCollector collector(config, functions.size());
+    for (const AnalysisSummary::DuplicatePair &pair : duplicatePairs) {
+        if (representatives[pair.firstFunction] == pair.firstFunction
+            && representatives[pair.secondFunction] == pair.secondFunction) {
+            collector.add(DuplicateCollector::Hit{pair.firstFunction, pair.secondFunction, pair.similarityIndex});
+        }
+    }
+
+    vector<AnalysisSummary::DuplicatePair> keptPairs;
+    for (const DuplicateCollector::Hit &hit : collector.getHits()) {
+        keptPairs.push_back(AnalysisSummary::DuplicatePair{hit.firstIndex, hit.secondIndex, hit.similarityIndex});
+    }
+
+    return AnalysisSummary(functions, move(longMethodFunctions), move(longParameterListFunctions), move(keptPairs),
+                           move(cloneGroups), vector<CodeSmellDetector::CloneRegion>(), comparedPairCount,
+                           collector.getDroppedCount());
+}
+
+size_t IncrementalAnalyzer::getChangedFunctionCount() const {
+    return changedFunctionCount;
+}
+
+size_t IncrementalAnalyzer::getComparedPairCount() const {
+    return comparedPairCount;
+}
+
+uint64_t IncrementalAnalyzer::hashCodeLines(Span<string_view> codeLines) {
+    uint64_t hash = Hash::mix(codeLines.size());
+    for (string_view line : codeLines) {
+        hash = Hash::combine(hash, Hash::bytes(line));
+    }
+    return hash;
+}
+
+double IncrementalAnalyzer::similarityIndex(const AnalysisSummary::FunctionMetrics &first,
+                                            const AnalysisSummary::FunctionMetrics &second) const {
+    if (config.similarityMetric == DetectorConfig::TOKEN_SHINGLE) {
+        return CodeSmellDetector::jaccardSimilarityIndex(Span<uint64_t>(first.shingles),
+                                                         Span<uint64_t>(second.shingles));
+    }
+    return CodeSmellDetector::jaccardSimilarityIndex(first.characterSignature, second.characterSignature);
+}
+
+vector<uint32_t> IncrementalAnalyzer::cloneRepresentatives() const {
+    if (!config.groupExactClones) {
+        vector<uint32_t> representatives(functions.size());
+        iota(representatives.begin(), representatives.end(), 0);
+        return representatives;
+    }
+    return CodeSmellDetector::findCloneRepresentatives(bodyHashes, [this](uint32_t first, uint32_t second) {
+        return bodies[first] == bodies[second];
+    });
+}
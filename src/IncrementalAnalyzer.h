@@ -0,0 +1,94 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_INCREMENTALANALYZER_H
+#define CODESMELLDETECTOR_INCREMENTALANALYZER_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "AnalysisSummary.h"
+#include "DetectorConfig.h"
+#include "Span.h"
+
+using namespace std;
+
+/**
+ * Keeps the analysis of one file up to date as it is edited. Every update re-parses the file
+ * and matches its functions against the previous version by a hash of their lines of code.
+ * Functions whose code did not change keep their metrics, signatures and duplicated pairs;
+ * only the changed functions are measured again and compared with the rest of the file, so
+ * a typical edit costs one function's worth of work instead of a full CodeSmellDetector run.
+ * Only the first version of the file (or any version after one without functions) gets a full run.
+ *
+ * The results are the same as analyzing the file from scratch with an exact duplicate search.
+ * Every duplicated pair is kept internally, so the duplicate limit and exact clone groups are
+ * applied when the summary is built and never lose a pair a later edit would bring back.
+ */
+class IncrementalAnalyzer {
+public:
+    /**
+     * Initialize the analyzer of a file that has no functions yet
+     * @param config detection settings, the duplicate search is always exact
+     */
+    explicit IncrementalAnalyzer(const DetectorConfig &config);
+
+    /**
+     * Re-analyze the file after a change
+     * @param linesFromFile lines of code from the current version of the file
+     * @throws invalid_argument if the file ends inside a function body, the previous results are kept
+     */
+    void update(const vector<string_view> &linesFromFile);
+
+    /**
+     * Build the results of the current version of the file
+     * @return summary in the same form as the one of a CodeSmellDetector
+     */
+    AnalysisSummary getSummary() const;
+
+    /**
+     * Get the number of functions the last update had to analyze again
+     * @return functions that were added or whose code changed
+     */
+    size_t getChangedFunctionCount() const;
+
+    /**
+     * Get the number of function pairs whose similarity index the last update computed
+     * @return number of compared pairs
+     */
+    size_t getComparedPairCount() const;
+
+private:
+    static constexpr const uint32_t UNMATCHED = UINT32_MAX; // A function with no counterpart in the other version
+
+    DetectorConfig config;
+    bool detectsDuplicates; // Duplicated Code is enabled, otherwise no signatures are built and no pairs compared
+    size_t changedFunctionCount;
+    size_t comparedPairCount;
+
+    // Parallel lists, one entry per function in file order
+    vector<AnalysisSummary::FunctionMetrics> functions;
+    vector<uint64_t> contentHashes; // Hash of the lines of code, decides if a function changed
+    vector<uint64_t> bodyHashes;    // Tokenizer::hashBody, groupExactClones only
+    vector<vector<uint32_t>> bodies; // Tokenizer::getBody, compared when hashes match, groupExactClones only
+
+    // Every duplicated pair regardless of the duplicate limit, in no particular order
+    vector<AnalysisSummary::DuplicatePair> duplicatePairs;
+
+    // Analyze the whole file with a CodeSmellDetector, which scans the pairs faster than one function at a time
+    void analyzeFromScratch(const vector<string_view> &linesFromFile);
+
+    // Hash of a function's lines of code
+    static uint64_t hashCodeLines(Span<string_view> codeLines);
+
+    // Similarity index of two functions under the configured metric
+    double similarityIndex(const AnalysisSummary::FunctionMetrics &first,
+                           const AnalysisSummary::FunctionMetrics &second) const;
+
+    // Index of the first function with the same body as each function, all functions without groupExactClones
+    vector<uint32_t> cloneRepresentatives() const;
+};
+
+
+#endif //CODESMELLDETECTOR_INCREMENTALANALYZER_H
@@ -0,0 +1,39 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_LINERANGE_H
+#define CODESMELLDETECTOR_LINERANGE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+/**
+ * A run of lines in a file, one based and inclusive at both ends.
+ */
+struct LineRange {
+    size_t firstLineNumber;
+    size_t lastLineNumber;
+
+    /**
+     * Does any of the ranges share a line with the given lines?
+     * @param ranges sorted ranges that do not overlap each other
+     * @param firstLineNumber first line to check (one based)
+     * @param lastLineNumber last line to check (one based)
+     * @return true if they share a line, false if not
+     */
+    static bool anyOverlaps(const vector<LineRange> &ranges, size_t firstLineNumber, size_t lastLineNumber) {
+        // The first range that does not end before the lines start
+        auto range = lower_bound(ranges.begin(), ranges.end(), firstLineNumber,
+                                 [](const LineRange &entry, size_t lineNumber) {
+                                     return entry.lastLineNumber < lineNumber;
+                                 });
+        return range != ranges.end() && range->firstLineNumber <= lastLineNumber;
+    }
+};
+
+
+#endif //CODESMELLDETECTOR_LINERANGE_H
@@ -0,0 +1,84 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "MinHashIndex.h"
+#include "Hash.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+MinHashIndex::MinHashIndex(size_t bandCount, size_t rowsPerBand) {
+    if (bandCount == 0 || rowsPerBand == 0) {
+        throw invalid_argument("LSH band and row counts must be positive");
+    }
+
+    this->bandCount = bandCount;
+    this->rowsPerBand = rowsPerBand;
+    this->bandBuckets.resize(bandCount);
+
+    uint64_t seed = SEED;
+    for (size_t i = 0; i < getSignatureLength(); i++) {
+        seed = Hash::mix(seed + i);
+        hashSeeds.push_back(seed);
+    }
+}
+
+size_t MinHashIndex::getSignatureLength() const {
+    return bandCount * rowsPerBand;
+}
+
+void MinHashIndex::computeSignature(Span<uint64_t> elements, uint32_t *signature) const {
+    for (size_t k = 0; k < hashSeeds.size(); k++) {
+        uint32_t minimum = UINT32_MAX;
+        for (uint64_t element : elements) {
+            minimum = min(minimum, static_cast<uint32_t>(Hash::mix(element ^ hashSeeds[k])));
+        }
+        signature[k] = minimum;
+    }
+}
+
+void MinHashIndex::computeSignature(const CharacterSignature &characters, uint32_t *signature) const {
+    vector<uint64_t> elements;
+    for (size_t c = 0; c < CharacterSignature::BIT_COUNT; c++) {
+        if (characters.contains(static_cast<char>(c))) {
+            elements.push_back(c);
+        }
+    }
+
+    computeSignature(elements, signature);
+}
+
+void MinHashIndex::add(uint32_t id, const uint32_t *signature) {
+    for (size_t band = 0; band < bandCount; band++) {
+        bandBuckets[band][bandKey(signature, band)].push_back(id);
+    }
+}
+
+void MinHashIndex::getCandidates(const uint32_t *signature, vector<uint32_t> &candidates) const {
+    candidates.clear();
+    for (size_t band = 0; band < bandCount; band++) {
+        auto bucket = bandBuckets[band].find(bandKey(signature, band));
+        if (bucket != bandBuckets[band].end()) {
+            candidates.insert(candidates.end(), bucket->second.begin(), bucket->second.end());
+        }
+    }
+
+    sort(candidates.begin(), candidates.end());
+    candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
+double MinHashIndex::candidateProbability(double similarity) const {
+    double bandMatch = pow(similarity, static_cast<double>(rowsPerBand));
+    return 1.0 - pow(1.0 - bandMatch, static_cast<double>(bandCount));
+}
+
+uint64_t MinHashIndex::bandKey(const uint32_t *signature, size_t band) const {
+    uint64_t key = band;
+    for (size_t row = 0; row < rowsPerBand; row++) {
+        key = Hash::combine(key, signature[band * rowsPerBand + row]);
+    }
+    return key;
+}
@@ -0,0 +1,88 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_MINHASHINDEX_H
+#define CODESMELLDETECTOR_MINHASHINDEX_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "CharacterSignature.h"
+#include "Span.h"
+
+using namespace std;
+
+/**
+ * Locality-sensitive hashing index over MinHash signatures. Every set is summarized by
+ * bands * rows minimum hash values; the signature is cut into bands and each band is hashed
+ * into a bucket. Two sets with Jaccard similarity s agree on any single MinHash value with
+ * probability s, so similar sets are very likely to share at least one bucket while
+ * dissimilar ones rarely do. Only pairs sharing a bucket need an exact comparison.
+ */
+class MinHashIndex {
+public:
+    /**
+     * Initialize an empty index
+     * @param bandCount number of bands
+     * @param rowsPerBand number of MinHash values per band
+     */
+    MinHashIndex(size_t bandCount, size_t rowsPerBand);
+
+    /**
+     * Get the number of MinHash values in a signature (bands * rows)
+     * @return signature length
+     */
+    size_t getSignatureLength() const;
+
+    /**
+     * Compute the MinHash signature of a set of hashed elements
+     * @param elements the set elements, duplicates are harmless
+     * @param signature output array of getSignatureLength() values
+     */
+    void computeSignature(Span<uint64_t> elements, uint32_t *signature) const;
+
+    /**
+     * Compute the MinHash signature of a character set
+     * @param characters the character set
+     * @param signature output array of getSignatureLength() values
+     */
+    void computeSignature(const CharacterSignature &characters, uint32_t *signature) const;
+
+    /**
+     * Insert a signature into the band buckets
+     * @param id identifier reported in candidate pairs
+     * @param signature array of getSignatureLength() values
+     */
+    void add(uint32_t id, const uint32_t *signature);
+
+    /**
+     * Get every id already in the index that shares at least one bucket with a signature.
+     * Querying each signature before adding it finds every candidate pair exactly once,
+     * without ever holding the full list of pairs.
+     * @param signature array of getSignatureLength() values
+     * @param candidates output list of ids, sorted and without duplicates
+     */
+    void getCandidates(const uint32_t *signature, vector<uint32_t> &candidates) const;
+
+    /**
+     * Probability that a pair with the given similarity becomes a candidate
+     * @param similarity Jaccard similarity of the pair
+     * @return 1 - (1 - similarity^rows)^bands
+     */
+    double candidateProbability(double similarity) const;
+
+private:
+    static const uint64_t SEED = 0x5eed5eed5eed5eedULL;
+
+    size_t bandCount;
+    size_t rowsPerBand;
+    vector<uint64_t> hashSeeds; // One per MinHash value
+    vector<unordered_map<uint64_t, vector<uint32_t>>> bandBuckets;
+
+    // Hash of the rows of one band, used as the bucket key
+    uint64_t bandKey(const uint32_t *signature, size_t band) const;
+};
+
+
+#endif //CODESMELLDETECTOR_MINHASHINDEX_H
@@ -3,6 +3,7 @@
 //
 
 #include "Parser.h"
+#include "StructuralIndex.h"
 #include <string>
 #include <stdexcept>
 #include <unordered_map>
@@ -17,8 +18,10 @@ const char Parser::WHITESPACE = ' ';
 const char Parser::FWD_SLASH = '/';
 const char Parser::ASTERISK = '*';
 const char Parser::AMPERSAND = '&';
-const string Parser::INCLUDE_DIRECTIVE = "#include";
-const string Parser::SENTINEL_VAL = "SKIP INDEX 0";
+const char Parser::DOUBLE_QUOTE = '"';
+const char Parser::SINGLE_QUOTE = '\'';
+const char Parser::BACKSLASH = '\\';
+const char Parser::HASH = '#';
 const unordered_map<char, char> Parser::BRACKET_MAP = {
         {OPENING_CURLY_BRACKET, CLOSING_CURLY_BRACKET},
         { OPENING_PAREN, CLOSING_PAREN}
@@ -26,84 +29,267 @@ const unordered_map<char, char> Parser::BRACKET_MAP = {
 
 using namespace std;
 
-Parser::Parser(const vector<string> &linesFromFile) {
-    this->linesFromFile = linesFromFile;
-    this->linesFromFile.insert(this->linesFromFile.begin(), SENTINEL_VAL);
+Parser::Parser(const vector<string_view> &linesFromFile) : linesFromFile(linesFromFile) {
     this->fileLineCount = linesFromFile.size();
 }
 
-vector<vector<string>> Parser::getFunctionContentList() {
-    vector<vector<string>> functionContentList;
-    size_t currentLineNumber = 1;
+string_view Parser::line(size_t lineNumber) const {
+    return linesFromFile[lineNumber - 1];
+}
+
+void Parser::forEachFunction(const FunctionHandler &handler) const {
+    ScanContext context;
+
+    size_t firstLineNumber = 1;
+    while (firstLineNumber <= fileLineCount) {
+        size_t lastLineNumber = findContiguousRunEnd(firstLineNumber);
+        scanLines(context, firstLineNumber, lastLineNumber, handler);
+        firstLineNumber = lastLineNumber + 1;
+    }
 
-    while (currentLineNumber < fileLineCount) {
-        skipBlankLines(currentLineNumber);
-        skipLinesUntilFunctionHeader(currentLineNumber);
-        size_t openParenLineNumber = currentLineNumber;
+    // Should never reach here assuming input file is valid (compilable) C++
+    if (context.scanState == IN_BODY) {
+        throw invalid_argument("Failed to find matching curly bracket");
+    }
+}
 
-        skipLinesUntilOpeningCurlyBracket(currentLineNumber);
-        size_t openCurlyLineNumber = currentLineNumber;
+size_t Parser::findContiguousRunEnd(size_t firstLineNumber) const {
+    size_t runSize = line(firstLineNumber).size();
+    size_t lastLineNumber = firstLineNumber;
 
-        size_t endLineNumber = findFunctionClosingCurlyBracketLine(openCurlyLineNumber);
+    while (lastLineNumber < fileLineCount) {
+        string_view currentLine = line(lastLineNumber);
+        string_view nextLine = line(lastLineNumber + 1);
 
-        // Now extract function content
-        vector<string> functionContent;
-        extractFunctionContent(functionContent, openParenLineNumber, endLineNumber);
-        functionContentList.push_back(functionContent);
-        currentLineNumber = endLineNumber + 1;
+        bool isContiguous = nextLine.data() == currentLine.data() + currentLine.size() + 1 &&
+            currentLine.data()[currentLine.size()] == '\n';
+        if (!isContiguous || runSize + 1 + nextLine.size() > UINT32_MAX) {
+            break;
+        }
+
+        runSize += 1 + nextLine.size();
+        lastLineNumber++;
     }
 
-    return functionContentList;
+    return lastLineNumber;
 }
 
-void Parser::skipBlankLines(size_t &currentLineNumber) {
-    while (currentLineNumber < fileLineCount && isBlankLine(linesFromFile[currentLineNumber])) {
-        currentLineNumber++;
+void Parser::scanLines(ScanContext &context, size_t firstLineNumber, size_t lastLineNumber,
+                       const FunctionHandler &handler) const {
+    string_view firstLine = line(firstLineNumber);
+    string_view lastLine = line(lastLineNumber);
+    string_view text(firstLine.data(), lastLine.data() + lastLine.size() - firstLine.data());
+    StructuralIndex structuralIndex(text);
+
+    size_t lineNumber = firstLineNumber;
+    size_t lineStart = 0;
+    context.escapedPosition = SIZE_MAX;
+    context.blockCommentBodyStart = 0; // Positions are within this run, a comment still open began in an earlier one
+    startLine(context, lineStart);
+
+    for (uint32_t position : structuralIndex.getPositions()) {
+        char currentChar = text[position];
+
+        if (currentChar == '\n') {
+            if (context.lexicalState == CODE) {
+                endCodeRegion(context, text, position);
+            }
+            finishLine(context, line(lineNumber), lineNumber, handler);
+            lineNumber++;
+            lineStart = position + 1;
+            startLine(context, lineStart);
+            continue;
+        }
+
+        switch (context.lexicalState) {
+            case LINE_COMMENT:
+                continue; // Rest of the line is a comment
+            case BLOCK_COMMENT:
+                // The '*' of "*/" must not be the one from the opening "/*"
+                if (currentChar == FWD_SLASH && position > context.blockCommentBodyStart &&
+                    text[position - 1] == ASTERISK) {
+                    context.lexicalState = CODE;
+                    context.codeRegionStart = position + 1;
+                }
+                continue;
+            case STRING_LITERAL:
+            case CHAR_LITERAL:
+                if (position == context.escapedPosition) {
+                    continue;
+                }
+                if (currentChar == BACKSLASH) {
+                    context.escapedPosition = position + 1; // Skip the escaped character
+                } else if (currentChar == (context.lexicalState == STRING_LITERAL ? DOUBLE_QUOTE : SINGLE_QUOTE)) {
+                    context.lexicalState = CODE;
+                    context.codeRegionStart = position + 1;
+                }
+                continue;
+            case CODE:
+                break;
+        }
+
+        char nextChar = position + 1 < text.size() ? text[position + 1] : '\0';
+        if (currentChar == FWD_SLASH && (nextChar == FWD_SLASH || nextChar == ASTERISK)) {
+            endCodeRegion(context, text, position);
+            context.lexicalState = nextChar == FWD_SLASH ? LINE_COMMENT : BLOCK_COMMENT;
+            context.blockCommentBodyStart = position + 2;
+        } else if (currentChar == DOUBLE_QUOTE || currentChar == SINGLE_QUOTE) {
+            endCodeRegion(context, text, position);
+            context.lastCodeChar = currentChar;
+            context.lexicalState = currentChar == DOUBLE_QUOTE ? STRING_LITERAL : CHAR_LITERAL;
+        } else {
+            handleCodeChar(context, currentChar, lineNumber, handler);
+        }
+    }
+
+    if (context.lexicalState == CODE) {
+        endCodeRegion(context, text, text.size());
     }
+    finishLine(context, lastLine, lineNumber, handler);
 }
 
-void Parser::skipLinesUntilFunctionHeader(size_t &currentLineNumber) {
-    while (currentLineNumber < fileLineCount && isNotBeginningOfFunctionDefinition(linesFromFile[currentLineNumber])) {
-        currentLineNumber++;
+void Parser::startLine(ScanContext &context, size_t lineStart) {
+    if (context.lexicalState != BLOCK_COMMENT) {
+        context.lexicalState = CODE;
+    }
+
+    if (context.scanState == SEEKING_HEADER) {
+        context.braceDepth = 0;
+        context.parenDepth = 0;
     }
+
+    context.lineHasOpenParen = false;
+    context.lineClosedFunction = false;
+    context.headerBodyClosed = false;
+    context.lastCodeChar = '\0';
+    context.codeRegionStart = lineStart;
 }
 
-void Parser::skipLinesUntilOpeningCurlyBracket(size_t &currentLineNumber) {
-    while (currentLineNumber < fileLineCount && !containsCharacter(linesFromFile[currentLineNumber], OPENING_CURLY_BRACKET)) {
-        currentLineNumber++;
+void Parser::endCodeRegion(ScanContext &context, string_view text, size_t regionEnd) {
+    for (size_t index = regionEnd; index > context.codeRegionStart; index--) {
+        if (!isWhitespace(text[index - 1])) {
+            context.lastCodeChar = text[index - 1];
+            return;
+        }
     }
 }
 
+void Parser::handleCodeChar(ScanContext &context, char currentChar, size_t lineNumber,
+                            const FunctionHandler &handler) {
+    if (context.lineClosedFunction) {
+        return;
+    }
 
-bool Parser::isBlankLine(const string &line) {
-    return line.empty() || line == "\r" || line == "\n";
+    if (currentChar == OPENING_PAREN) {
+        context.lineHasOpenParen = true;
+        context.parenDepth++;
+    } else if (currentChar == CLOSING_PAREN && context.parenDepth > 0) {
+        context.parenDepth--;
+    }
+
+    switch (context.scanState) {
+        case SEEKING_HEADER:
+            // Whether this line is a header is only known at its end, so track its
+            // curly brackets in case the body starts (or even ends) on the same line
+            if (context.headerBodyClosed) {
+                break;
+            }
+            if (currentChar == OPENING_CURLY_BRACKET) {
+                context.braceDepth++;
+            } else if (currentChar == CLOSING_CURLY_BRACKET && context.braceDepth > 0) {
+                context.braceDepth--;
+                context.headerBodyClosed = context.braceDepth == 0;
+            }
+            break;
+        case SEEKING_BODY:
+            if (currentChar == OPENING_CURLY_BRACKET) {
+                context.scanState = IN_BODY;
+                context.braceDepth = 1;
+            } else if (currentChar == SEMICOLON && context.parenDepth == 0) {
+                // Multi-line forward declaration, not a definition
+                context.scanState = SEEKING_HEADER;
+                context.lineClosedFunction = true;
+            }
+            break;
+        case IN_BODY:
+            if (currentChar == OPENING_CURLY_BRACKET) {
+                context.braceDepth++;
+            } else if (currentChar == CLOSING_CURLY_BRACKET && --context.braceDepth == 0) {
+                handler(context.headerLineNumber, lineNumber);
+                context.scanState = SEEKING_HEADER;
+                context.lineClosedFunction = true;
+            }
+            break;
+    }
 }
 
-void Parser::extractFunctionContent(vector<string> &functionContent, size_t startLineNumber, size_t endLineNumber) {
-    for (size_t i = startLineNumber; i <= endLineNumber; i++) {
-        string line = linesFromFile[i];
+void Parser::finishLine(ScanContext &context, string_view currentLine, size_t lineNumber,
+                        const FunctionHandler &handler) {
+    if (context.scanState != SEEKING_HEADER || context.lineClosedFunction) {
+        return;
+    }
+
+    // A line that starts with a comment is left out of the function content, so it cannot be the header
+    bool isHeader = context.lineHasOpenParen &&
+        context.lastCodeChar != SEMICOLON && // if is a forward declaration
+        !isDirective(currentLine) && !isComment(currentLine);
+    if (!isHeader) {
+        return;
+    }
+
+    context.headerLineNumber = lineNumber;
+    if (context.headerBodyClosed) {
+        handler(lineNumber, lineNumber);
+    } else if (context.braceDepth > 0) {
+        context.scanState = IN_BODY;
+    } else {
+        context.scanState = SEEKING_BODY;
+    }
+}
+
+Span<string_view> Parser::getFunctionContent(size_t firstLineNumber, size_t lastLineNumber,
+                                             pmr::memory_resource *arena) const {
+    // Sized for the whole range, the few slots of skipped lines go unused
+    pmr::polymorphic_allocator<string_view> allocator(arena);
+    string_view *functionContent = allocator.allocate(lastLineNumber - firstLineNumber + 1);
+    size_t contentLineCount = 0;
+
+    for (size_t i = firstLineNumber; i <= lastLineNumber; i++) {
+        string_view currentLine = line(i);
 
         // Ignore blank lines and comments
-        if (isBlankLine(line) || isComment(line)) {
+        if (isBlankLine(currentLine) || isComment(currentLine)) {
             continue;
         }
 
-        functionContent.push_back(line);
+        functionContent[contentLineCount++] = currentLine;
     }
+
+    return Span<string_view>(functionContent, contentLineCount);
+}
+
+Span<string_view> Parser::getFunctionSource(size_t firstLineNumber, size_t lastLineNumber) const {
+    return Span<string_view>(linesFromFile.data() + firstLineNumber - 1, lastLineNumber - firstLineNumber + 1);
 }
 
-size_t Parser::getClosingBracketIndex(const string &line, const char &openingBracket) {
+bool Parser::isBlankLine(string_view line) {
+    return line.empty() || line == "\r" || line == "\n";
+}
+
+size_t Parser::getClosingBracketIndex(string_view line, const char &openingBracket) {
     size_t startAtZero = 0;
     return Parser::getClosingBracketIndex(line, openingBracket, startAtZero);
 }
 
-size_t Parser::getClosingBracketIndex(const string &line, const char &openingBracket, size_t &openCount) {
+size_t Parser::getClosingBracketIndex(string_view line, const char &openingBracket, size_t &openCount) {
+    const char closingBracket = BRACKET_MAP.at(openingBracket); // Look up once, not per character
+
     for (size_t index = 0; index < line.size(); index++) {
         char currentChar = line[index];
 
         if (currentChar == openingBracket) {
             openCount++;
-        } else if (currentChar == BRACKET_MAP.at(openingBracket)) {
+        } else if (currentChar == closingBracket) {
             if (openCount == 1) {
                 // Found initial matching bracket
                 return index;
@@ -117,43 +303,17 @@ size_t Parser::getClosingBracketIndex(const string &line, const char &openingBra
     return NOT_FOUND;
 }
 
-size_t Parser::findFunctionClosingCurlyBracketLine(size_t startLineNumber) {
-    size_t openCurlyCount = 0;
-    for (size_t currentLineNumber = startLineNumber; currentLineNumber < linesFromFile.size(); currentLineNumber++) {
-        size_t closingIndex = getClosingBracketIndex(linesFromFile[currentLineNumber], OPENING_CURLY_BRACKET, openCurlyCount);
-
-        if (closingIndex != NOT_FOUND) {
-            // Found the closing bracket on the current line number
-            return currentLineNumber;
-        }
-    }
-
-    // Should never reach here assuming input file is valid (compilable) C++
-    throw invalid_argument("Failed to find matching curly bracket");
-}
-
-bool Parser::containsCharacter(const string &str, const char &character) {
-    return str.find(character) != string::npos;
+bool Parser::isComment(string_view line) {
+    size_t firstIndex = line.find_first_not_of(WHITESPACE); // Skip leading whitespace
+    return firstIndex != string_view::npos && line[firstIndex] == FWD_SLASH;
 }
 
-bool Parser::isNotBeginningOfFunctionDefinition(const string &line) {
-    return isBlankLine(line) ||
-        isComment(line) ||
-        line.find(INCLUDE_DIRECTIVE) != string::npos || // if is #include directive
-        !containsCharacter(line, OPENING_PAREN) || // if does not have opening parenthesis
-        lineEndsWith(line, SEMICOLON); // if is a forward declarations
+bool Parser::isDirective(string_view line) {
+    size_t firstIndex = line.find_first_not_of(" \t");
+    return firstIndex != string_view::npos && line[firstIndex] == HASH;
 }
 
-bool Parser::isComment(const string &line) {
-    if (line.empty()) {
-        return false;
-    }
-
-    string strToCompare = line.substr(line.find_first_not_of(WHITESPACE)); // Strip leading whitespace
-    return strToCompare[0] == FWD_SLASH;
+bool Parser::isWhitespace(char character) {
+    return character == ' ' || character == '\t' || character == '\r' || character == '\n' ||
+        character == '\v' || character == '\f';
 }
-
-bool Parser::lineEndsWith(const string &line, const char &character) {
-    size_t lastIndex = line.find_last_not_of(" \r\n"); // Ignore whitespace and carriage return
-    return line[lastIndex] == character;
-}
\ No newline at end of file
@@ -5,9 +5,13 @@
 #ifndef CODESMELLDETECTOR_PARSER_H
 #define CODESMELLDETECTOR_PARSER_H
 
+#include <functional>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
+#include "Span.h"
 using namespace std;
 
 /**
@@ -19,18 +23,21 @@ public:
     static const char OPENING_PAREN, CLOSING_PAREN,
         OPENING_CURLY_BRACKET, CLOSING_CURLY_BRACKET,
         COMMA, SEMICOLON, WHITESPACE, FWD_SLASH,
-        ASTERISK, AMPERSAND;
+        ASTERISK, AMPERSAND, DOUBLE_QUOTE, SINGLE_QUOTE,
+        BACKSLASH, HASH;
 
-    static const string INCLUDE_DIRECTIVE;
     static const size_t NOT_FOUND = SIZE_MAX;
-    static const string SENTINEL_VAL; // Using one based indexing to match line numbers
     static const unordered_map<char, char> BRACKET_MAP; // Match opening brackets to their closing brackets
 
+    // Receives the first and last line number (one based) of each function found
+    typedef function<void(size_t firstLineNumber, size_t lastLineNumber)> FunctionHandler;
+
     /**
-     * Initialize the line count and file lines list.
+     * Initialize the line count and file lines list. The lines are not copied, so they
+     * (and the buffer they point into) must outlive the parser and the extracted content.
      * @param linesFromFile lines of code from the input file
      */
-    explicit Parser(const vector<string> &linesFromFile);
+    explicit Parser(const vector<string_view> &linesFromFile);
 
     /**
      * Get the index of the matching closing bracket. Defaults the count of the open brackets to 0.
@@ -38,33 +45,106 @@ public:
      * @param openingBracket opening bracket to match
      * @return index where matching closing bracket resides
      */
-    static size_t getClosingBracketIndex(const string &line, const char &openingBracket);
+    static size_t getClosingBracketIndex(string_view line, const char &openingBracket);
+
+    /**
+     * Find every function definition in a single forward pass over the file. The handler
+     * is called for each function as soon as its closing curly bracket is seen. Lines that
+     * sit back to back in one buffer (as with SourceFile) are indexed in bulk with a
+     * StructuralIndex and only the structural characters are visited.
+     * @param handler receives the line range of each function
+     * @throws invalid_argument if the file ends inside a function body
+     */
+    void forEachFunction(const FunctionHandler &handler) const;
+
+    /**
+     * Get the lines of a function, skipping blank lines and comment lines
+     * @param firstLineNumber line of the function header (one based)
+     * @param lastLineNumber line of the closing curly bracket (one based)
+     * @param arena memory the array of views is allocated from
+     * @return views of the function's lines of code
+     */
+    Span<string_view> getFunctionContent(size_t firstLineNumber, size_t lastLineNumber,
+                                         pmr::memory_resource *arena) const;
 
     /**
-     * Stores each line of code from a function into a list. That list is then stored in
-     * another list which contains all of the function content lists.
-     * @return vector of function content vectors (2D vector)
+     * Get every line of a function as it is in the file, blank and comment lines included.
+     * This is what to lex, the content leaves out the line a block comment starts on.
+     * @param firstLineNumber line of the function header (one based)
+     * @param lastLineNumber line of the closing curly bracket (one based)
+     * @return views of the function's lines, the line index plus firstLineNumber is the line number
      */
-    vector<vector<string>> getFunctionContentList();
+    Span<string_view> getFunctionSource(size_t firstLineNumber, size_t lastLineNumber) const;
 
 private:
+    /*
+     * Where the scanner is with respect to the text: inside code, or inside something whose
+     * brackets and semicolons must not count. Line comments and unterminated literals end
+     * with their line; block comments carry over to the next line.
+     */
+    enum LexicalState {
+        CODE, LINE_COMMENT, BLOCK_COMMENT, STRING_LITERAL, CHAR_LITERAL
+    };
+
+    /*
+     * Where the scanner is with respect to functions. A header is a line that has an opening
+     * parenthesis in code and does not end with a semicolon (a forward declaration). After
+     * the header comes the opening curly bracket, unless a semicolon shows up first, and then
+     * the body runs until the curly brackets balance out.
+     */
+    enum ScanState {
+        SEEKING_HEADER, SEEKING_BODY, IN_BODY
+    };
+
+    // Everything the state machine tracks while it walks the file
+    struct ScanContext {
+        LexicalState lexicalState = CODE;
+        ScanState scanState = SEEKING_HEADER;
+        size_t headerLineNumber = 0;
+        size_t braceDepth = 0;
+        size_t parenDepth = 0;
+
+        // Facts about the current line, reset at every line start
+        bool lineHasOpenParen = false;
+        bool lineClosedFunction = false; // The current line already finished a function, ignore the rest of it
+        bool headerBodyClosed = false;   // A one-line body opened and closed on the current line
+        char lastCodeChar = '\0';
+
+        // Offsets into the text of the run of lines being scanned
+        size_t codeRegionStart = 0;   // Where the current stretch of code (outside comments and literals) began
+        size_t blockCommentBodyStart = 0; // First position of the current block comment after its "/*", 0 in later runs
+        size_t escapedPosition = SIZE_MAX; // Character escaped by a backslash inside a literal
+    };
+
     size_t fileLineCount;
-    vector<string> linesFromFile;
+    const vector<string_view> &linesFromFile;
+
+    // Using one based indexing to match line numbers
+    string_view line(size_t lineNumber) const;
+
+    // Get the last line number of the run of lines starting at firstLineNumber that are
+    // stored back to back, separated by single newlines
+    size_t findContiguousRunEnd(size_t firstLineNumber) const;
 
-    // Extract each line of code from the function and store in the content vector
-    void extractFunctionContent(vector<string> &functionContent, size_t startLineNumber, size_t endLineNumber);
+    // Run the state machine over one run of contiguous lines
+    void scanLines(ScanContext &context, size_t firstLineNumber, size_t lastLineNumber,
+                   const FunctionHandler &handler) const;
 
-    // Skip lines while updating currentLineNumber (passed by reference)
-    void skipBlankLines(size_t &currentLineNumber);
-    void skipLinesUntilFunctionHeader(size_t &currentLineNumber);
-    void skipLinesUntilOpeningCurlyBracket(size_t &currentLineNumber);
+    // State machine steps
+    static void startLine(ScanContext &context, size_t lineStart);
+    static void handleCodeChar(ScanContext &context, char currentChar, size_t lineNumber,
+                               const FunctionHandler &handler);
+    static void finishLine(ScanContext &context, string_view currentLine, size_t lineNumber,
+                           const FunctionHandler &handler);
+
+    // The stretch of code ending at regionEnd is over, remember its last non-whitespace character
+    static void endCodeRegion(ScanContext &context, string_view text, size_t regionEnd);
 
     // Helper functions for checking characteristics of the line of code
-    static bool lineEndsWith(const string &line, const char &character);
-    static bool isComment(const string &line);
-    static bool isNotBeginningOfFunctionDefinition(const string &line);
-    static bool isBlankLine(const string &line);
-    static bool containsCharacter(const string &str, const char &character);
+    static bool isComment(string_view line);
+    static bool isBlankLine(string_view line);
+    static bool isDirective(string_view line);
+    static bool isWhitespace(char character);
 
     /*
      * Get the index of the matching closing bracket, while using the count of the open brackets passed in
@@ -72,10 +152,7 @@ private:
      * brackets that haven't been matched yet, but we don't actually need a stack and can just keep
      * track of the count instead.
      */
-    static size_t getClosingBracketIndex(const string &line, const char &openingBracket, size_t &openCount);
-
-    // This just finds the closing bracket index, but returns the line number it was found on instead.
-    size_t findFunctionClosingCurlyBracketLine(size_t startLineNumber);
+    static size_t getClosingBracketIndex(string_view line, const char &openingBracket, size_t &openCount);
 };
 
 
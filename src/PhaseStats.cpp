@@ -0,0 +1,226 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "PhaseStats.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+using namespace std;
+
+atomic<bool> PhaseStats::enabled{false};
+chrono::steady_clock::time_point PhaseStats::runStart;
+PhaseStats::PhaseTotals PhaseStats::totals[PHASE_COUNT];
+
+namespace {
+    thread_local uint64_t allocatedBytes = 0;
+    thread_local PhaseStats::Scope *currentScope = nullptr;
+
+    uint64_t nanosecondsSince(chrono::steady_clock::time_point start) {
+        return static_cast<uint64_t>(
+                chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+    }
+}
+
+#ifdef CODESMELLDETECTOR_STATS
+// Counting replacements for the global allocation functions. The array and nothrow forms
+// call these, so every heap allocation on a thread is seen.
+void *operator new(size_t size) {
+    allocatedBytes += size;
+    void *memory = malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+        throw bad_alloc();
+    }
+    return memory;
+}
+
+void *operator new(size_t size, align_val_t alignment) {
+    allocatedBytes += size;
+    size_t alignmentBytes = static_cast<size_t>(alignment);
+    size_t roundedSize = (max<size_t>(size, 1) + alignmentBytes - 1) / alignmentBytes * alignmentBytes;
+    void *memory = aligned_alloc(alignmentBytes, roundedSize);
+    if (memory == nullptr) {
+        throw bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+    free(memory);
+}
+
+void operator delete(void *memory, align_val_t) noexcept {
+    free(memory);
+}
+
+void operator delete(void *memory, size_t, align_val_t) noexcept {
+    free(memory);
+}
+#endif
+
+bool PhaseStats::isCompiledIn() {
+#ifdef CODESMELLDETECTOR_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PhaseStats::enable() {
+    runStart = chrono::steady_clock::now();
+    enabled = true;
+}
+
+bool PhaseStats::isEnabled() {
+    return enabled.load(memory_order_relaxed);
+}
+
+void PhaseStats::addItems(Phase phase, size_t items) {
+    if (isEnabled()) {
+        totals[phase].items.fetch_add(items, memory_order_relaxed);
+    }
+}
+
+uint64_t PhaseStats::threadAllocatedBytes() {
+    return allocatedBytes;
+}
+
+PhaseStats::Scope::Scope(Phase phase) {
+    this->phase = phase;
+    this->active = isEnabled();
+    this->parent = nullptr;
+    this->startBytes = 0;
+    this->nestedNanoseconds = 0;
+    this->nestedBytes = 0;
+
+    if (active) {
+        parent = currentScope;
+        currentScope = this;
+        startBytes = allocatedBytes;
+        start = chrono::steady_clock::now();
+    }
+}
+
+PhaseStats::Scope::~Scope() {
+    if (!active) {
+        return;
+    }
+
+    uint64_t nanoseconds = nanosecondsSince(start);
+    uint64_t bytes = allocatedBytes - startBytes;
+
+    PhaseTotals &phaseTotals = totals[phase];
+    phaseTotals.nanoseconds.fetch_add(nanoseconds - min(nanoseconds, nestedNanoseconds), memory_order_relaxed);
+    phaseTotals.bytes.fetch_add(bytes - min(bytes, nestedBytes), memory_order_relaxed);
+    phaseTotals.calls.fetch_add(1, memory_order_relaxed);
+
+    // The enclosing scope must not charge this time and memory to its own phase
+    if (parent != nullptr) {
+        parent->nestedNanoseconds += nanoseconds;
+        parent->nestedBytes += bytes;
+    }
+    currentScope = parent;
+}
+
+void PhaseStats::print(ostream &out, OutputFormat format) {
+    if (!isCompiledIn()) {
+        out << "Statistics are not available, the program was built with STATS=0." << endl;
+        return;
+    }
+
+    double wallMilliseconds = static_cast<double>(nanosecondsSince(runStart)) / 1e6;
+    double phaseMilliseconds = 0;
+    for (const PhaseTotals &phaseTotals : totals) {
+        phaseMilliseconds += static_cast<double>(phaseTotals.nanoseconds.load()) / 1e6;
+    }
+
+    if (format == JSON) {
+        out << "{\"wallTimeMs\":" << setprecision(3) << fixed << wallMilliseconds << ",\"phases\":[";
+        for (size_t i = 0; i < PHASE_COUNT; i++) {
+            const PhaseTotals &phaseTotals = totals[i];
+            out << (i == 0 ? "" : ",")
+                << "{\"phase\":\"" << phaseName(static_cast<Phase>(i)) << "\""
+                << ",\"timeMs\":" << static_cast<double>(phaseTotals.nanoseconds.load()) / 1e6
+                << ",\"calls\":" << phaseTotals.calls.load()
+                << ",\"items\":" << phaseTotals.items.load()
+                << ",\"itemUnit\":\"" << itemName(static_cast<Phase>(i)) << "\""
+                << ",\"bytesAllocated\":" << phaseTotals.bytes.load() << "}";
+        }
+        out << "]}" << endl;
+        return;
+    }
+
+    out << left << setw(28) << "Phase" << right << setw(12) << "Time (ms)" << setw(8) << "Share"
+        << setw(22) << "Items" << setw(16) << "Allocated (KB)" << endl;
+    for (size_t i = 0; i < PHASE_COUNT; i++) {
+        const PhaseTotals &phaseTotals = totals[i];
+        double milliseconds = static_cast<double>(phaseTotals.nanoseconds.load()) / 1e6;
+        double share = phaseMilliseconds > 0 ? milliseconds * 100 / phaseMilliseconds : 0;
+
+        out << left << setw(28) << phaseName(static_cast<Phase>(i)) << right
+            << setw(12) << setprecision(2) << fixed << milliseconds
+            << setw(7) << setprecision(1) << share << "%"
+            << setw(12) << phaseTotals.items.load() << " " << left << setw(9) << itemName(static_cast<Phase>(i))
+            << right << setw(16) << phaseTotals.bytes.load() / 1024 << endl;
+    }
+    out << "Phase times are summed over all threads; wall time " << setprecision(2) << fixed
+        << wallMilliseconds << " ms." << endl;
+}
+
+const char *PhaseStats::phaseName(Phase phase) {
+    switch (phase) {
+        case READ_FILE:
+            return "read file";
+        case CACHE:
+            return "cache";
+        case PARSE:
+            return "parse";
+        case CONSTRUCT_FUNCTIONS:
+            return "construct functions";
+        case LEX_TOKENS:
+            return "lex tokens";
+        case BUILD_SIGNATURES:
+            return "build signatures";
+        case DETECT_FUNCTION_SMELLS:
+            return "detect function smells";
+        case DETECT_EXACT_CLONES:
+            return "detect exact clones";
+        case DETECT_DUPLICATED_CODE:
+            return "detect duplicated code";
+        case FILTER_PAIRS:
+            return "filter pairs";
+        case DETECT_CLONE_REGIONS:
+            return "detect clone regions";
+        case CROSS_FILE_INDEX:
+            return "cross-file index";
+        case RENDER_REPORT:
+            return "render report";
+        default:
+            return "unknown";
+    }
+}
+
+const char *PhaseStats::itemName(Phase phase) {
+    switch (phase) {
+        case READ_FILE:
+        case PARSE:
+            return "lines";
+        case CACHE:
+        case RENDER_REPORT:
+            return "files";
+        case DETECT_DUPLICATED_CODE:
+        case FILTER_PAIRS:
+            return "pairs";
+        case LEX_TOKENS:
+        case DETECT_CLONE_REGIONS:
+            return "tokens";
+        default:
+            return "functions";
+    }
+}
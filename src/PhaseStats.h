@@ -0,0 +1,137 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_PHASESTATS_H
+#define CODESMELLDETECTOR_PHASESTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+using namespace std;
+
+/**
+ * Where the time goes: wall time, item counts and bytes allocated for each phase of the
+ * analysis, summed over all threads and printed by --stats. Code marks a phase with
+ * PHASE_SCOPE and counts its items with PHASE_ITEMS. Time spent in a nested scope is only
+ * charged to the nested phase, so the phases add up to the total without double counting.
+ * Allocated bytes are everything requested from operator new while the phase was running.
+ *
+ * Recording only happens after enable(). Building without CODESMELLDETECTOR_STATS defined
+ * (make STATS=0) turns both macros into nothing and leaves operator new alone, so the
+ * instrumentation costs nothing at all.
+ */
+class PhaseStats {
+public:
+    enum Phase {
+        READ_FILE,                  // Items: lines
+        CACHE,                      // Items: files looked up
+        PARSE,                      // Items: lines
+        CONSTRUCT_FUNCTIONS,        // Items: functions
+        LEX_TOKENS,                 // Items: tokens
+        BUILD_SIGNATURES,           // Items: functions
+        DETECT_FUNCTION_SMELLS,     // Items: functions
+        DETECT_EXACT_CLONES,        // Items: functions
+        DETECT_DUPLICATED_CODE,     // Items: pairs compared
+        FILTER_PAIRS,               // Items: pairs pruned without comparing them
+        DETECT_CLONE_REGIONS,       // Items: tokens
+        CROSS_FILE_INDEX,           // Items: functions
+        RENDER_REPORT,              // Items: files
+        PHASE_COUNT
+    };
+
+    enum OutputFormat {
+        TABLE, // Aligned columns for people
+        JSON   // A single JSON object
+    };
+
+    /**
+     * Is the instrumentation built in?
+     * @return true unless it was compiled out
+     */
+    static bool isCompiledIn();
+
+    /**
+     * Start recording and start the wall clock for the run. Call before any worker starts.
+     */
+    static void enable();
+
+    /**
+     * Is recording on?
+     * @return true after enable()
+     */
+    static bool isEnabled();
+
+    /**
+     * Add items to a phase's count
+     * @param phase phase the items belong to
+     * @param items number of items
+     */
+    static void addItems(Phase phase, size_t items);
+
+    /**
+     * Print the collected numbers
+     * @param out stream to print to
+     * @param format table or JSON
+     */
+    static void print(ostream &out, OutputFormat format);
+
+    /**
+     * Charges the time and allocations between its construction and destruction to a phase.
+     * Use through PHASE_SCOPE.
+     */
+    class Scope {
+    public:
+        explicit Scope(Phase phase);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        Phase phase;
+        bool active;
+        Scope *parent;
+        chrono::steady_clock::time_point start;
+        uint64_t startBytes;
+        uint64_t nestedNanoseconds; // Already charged to scopes inside this one
+        uint64_t nestedBytes;
+    };
+
+    /**
+     * Get the bytes requested from operator new on the calling thread so far
+     * @return byte count
+     */
+    static uint64_t threadAllocatedBytes();
+
+private:
+    // One row of the report, updated from every thread
+    struct PhaseTotals {
+        atomic<uint64_t> nanoseconds{0};
+        atomic<uint64_t> calls{0};
+        atomic<uint64_t> items{0};
+        atomic<uint64_t> bytes{0};
+    };
+
+    static atomic<bool> enabled;
+    static chrono::steady_clock::time_point runStart;
+    static PhaseTotals totals[PHASE_COUNT];
+
+    static const char *phaseName(Phase phase);
+    static const char *itemName(Phase phase);
+};
+
+#ifdef CODESMELLDETECTOR_STATS
+#define PHASE_STATS_CONCAT_(a, b) a##b
+#define PHASE_STATS_CONCAT(a, b) PHASE_STATS_CONCAT_(a, b)
+#define PHASE_SCOPE(phase) PhaseStats::Scope PHASE_STATS_CONCAT(phaseScope, __LINE__)(PhaseStats::phase)
+#define PHASE_ITEMS(phase, items) PhaseStats::addItems(PhaseStats::phase, (items))
+#else
+#define PHASE_SCOPE(phase) ((void) 0)
+#define PHASE_ITEMS(phase, items) ((void) 0)
+#endif
+
+
+#endif //CODESMELLDETECTOR_PHASESTATS_H
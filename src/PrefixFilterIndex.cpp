@@ -0,0 +1,150 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "PrefixFilterIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace std;
+
+PrefixFilterIndex::PrefixFilterIndex(const vector<Span<uint64_t>> &sets, double similarityThreshold) {
+    this->similarityThreshold = similarityThreshold;
+
+    for (size_t i = 1; i < sets.size(); i++) {
+        if (sets[i].size() < sets[i - 1].size()) {
+            throw invalid_argument("prefix filter sets must be ordered by ascending size");
+        }
+    }
+
+    // Rank the elements from the rarest to the most common, ties by value so ranks are deterministic
+    unordered_map<uint64_t, uint32_t> ranks;
+    for (Span<uint64_t> set : sets) {
+        for (uint64_t element : set) {
+            ranks[element]++;
+        }
+    }
+    vector<pair<uint32_t, uint64_t>> byFrequency;
+    byFrequency.reserve(ranks.size());
+    for (const pair<const uint64_t, uint32_t> &entry : ranks) {
+        byFrequency.emplace_back(entry.second, entry.first);
+    }
+    sort(byFrequency.begin(), byFrequency.end());
+    for (size_t rank = 0; rank < byFrequency.size(); rank++) {
+        ranks[byFrequency[rank].second] = static_cast<uint32_t>(rank);
+    }
+
+    setOffsets.reserve(sets.size() + 1);
+    setOffsets.push_back(0);
+    for (Span<uint64_t> set : sets) {
+        for (uint64_t element : set) {
+            elements.push_back(ranks[element]);
+        }
+        sort(elements.begin() + static_cast<ptrdiff_t>(setOffsets.back()), elements.end());
+        setOffsets.push_back(elements.size());
+    }
+
+    // Counting sort of the prefix elements into one posting list per rank
+    postingOffsets.assign(byFrequency.size() + 1, 0);
+    for (size_t position = 0; position < size(); position++) {
+        for (size_t i = 0; i < prefixLength(setSize(position)); i++) {
+            postingOffsets[elements[setOffsets[position] + i] + 1]++;
+        }
+    }
+    partial_sum(postingOffsets.begin(), postingOffsets.end(), postingOffsets.begin());
+
+    postings.resize(postingOffsets.back());
+    vector<size_t> nextPosting(postingOffsets.begin(), postingOffsets.end() - 1);
+    for (size_t position = 0; position < size(); position++) {
+        for (size_t i = 0; i < prefixLength(setSize(position)); i++) {
+            postings[nextPosting[elements[setOffsets[position] + i]]++] =
+                    Posting{static_cast<uint32_t>(position), static_cast<uint32_t>(i)};
+        }
+    }
+}
+
+size_t PrefixFilterIndex::size() const {
+    return setOffsets.size() - 1;
+}
+
+void PrefixFilterIndex::findCandidates(size_t position, Probe &probe) const {
+    probe.candidates.clear();
+    if (probe.overlaps.size() < size()) {
+        probe.overlaps.assign(size(), 0);
+    }
+
+    size_t probeSize = setSize(position);
+    const uint32_t *probeElements = elements.data() + setOffsets[position];
+
+    // Earlier sets are never larger, and the similarity is at most the ratio of the two sizes
+    size_t firstPosition = firstPositionOfSize(smallestAbove(similarityThreshold * static_cast<double>(probeSize)));
+
+    for (size_t i = 0; i < prefixLength(probeSize); i++) {
+        const Posting *posting = postings.data() + postingOffsets[probeElements[i]];
+        const Posting *postingsEnd = postings.data() + postingOffsets[probeElements[i] + 1];
+        posting = lower_bound(posting, postingsEnd, firstPosition, [](const Posting &entry, size_t minimum) {
+            return entry.position < minimum;
+        });
+
+        for (; posting != postingsEnd && posting->position < position; posting++) {
+            uint32_t &overlap = probe.overlaps[posting->position];
+            if (overlap == PRUNED) {
+                continue;
+            }
+            if (overlap == 0) {
+                probe.candidates.push_back(posting->position);
+            }
+
+            // Shared elements ranked before this one are all counted already, and at best every
+            // element after it in the smaller remainder is shared too
+            size_t otherSize = setSize(posting->position);
+            size_t requiredOverlap = smallestAbove(similarityThreshold * static_cast<double>(probeSize + otherSize)
+                                                   / (1 + similarityThreshold));
+            size_t maximumOverlap = overlap + 1 + min(probeSize - i - 1, otherSize - posting->elementPosition - 1);
+            overlap = maximumOverlap >= requiredOverlap ? overlap + 1 : PRUNED;
+        }
+    }
+
+    // Keep the survivors and leave the scratch space clean for the next call
+    size_t keptCount = 0;
+    for (uint32_t candidate : probe.candidates) {
+        if (probe.overlaps[candidate] != PRUNED) {
+            probe.candidates[keptCount++] = candidate;
+        }
+        probe.overlaps[candidate] = 0;
+    }
+    probe.candidates.resize(keptCount);
+}
+
+size_t PrefixFilterIndex::setSize(size_t position) const {
+    return setOffsets[position + 1] - setOffsets[position];
+}
+
+size_t PrefixFilterIndex::firstPositionOfSize(size_t minimumSize) const {
+    size_t low = 0;
+    size_t high = size();
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (setSize(middle) < minimumSize) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+size_t PrefixFilterIndex::prefixLength(size_t setSize) const {
+    // A similar set shares more than threshold * setSize elements with this one, so it must
+    // share one of the first setSize - requiredOverlap + 1
+    size_t requiredOverlap = smallestAbove(similarityThreshold * static_cast<double>(setSize));
+    return min(setSize, setSize - min(setSize, requiredOverlap) + 1);
+}
+
+size_t PrefixFilterIndex::smallestAbove(double bound) {
+    double rounded = ceil(bound - BOUND_SLACK);
+    return rounded > 0 ? static_cast<size_t>(rounded) : 0;
+}
@@ -0,0 +1,85 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_PREFIXFILTERINDEX_H
+#define CODESMELLDETECTOR_PREFIXFILTERINDEX_H
+
+#include <cstdint>
+#include <vector>
+#include "Span.h"
+
+using namespace std;
+
+/**
+ * Exact candidate generation for Jaccard similarity above a threshold, in the style of
+ * AllPairs/PPJoin. Every set is rewritten with its rarest elements first. If two sets are
+ * similar enough they must overlap in at least a known number of elements, and then the
+ * first few elements of each (its prefix) must share at least one element. Only prefixes are
+ * indexed, so a set is only ever paired with the sets that share a prefix element, and pairs
+ * whose sizes or element positions already rule out enough overlap are dropped as well.
+ *
+ * The filters never drop a pair whose similarity is above the threshold: the candidates are a
+ * superset of the similar pairs, and still have to be compared exactly.
+ */
+class PrefixFilterIndex {
+public:
+    // Scratch space for findCandidates, one per thread
+    struct Probe {
+        vector<uint32_t> overlaps;   // Prefix elements shared with each earlier set so far
+        vector<uint32_t> candidates; // Positions of the sets found by the last call
+    };
+
+    /**
+     * Rank the elements by how many sets they appear in and index the prefix of every set
+     * @param sets sorted lists of distinct hashed elements, ordered by ascending size
+     * @param similarityThreshold pairs need a Jaccard similarity above this to be candidates
+     */
+    PrefixFilterIndex(const vector<Span<uint64_t>> &sets, double similarityThreshold);
+
+    /**
+     * Get the number of indexed sets
+     * @return set count
+     */
+    size_t size() const;
+
+    /**
+     * Find the sets before a set that may be more similar to it than the threshold
+     * @param position position of the set in the list the index was built from
+     * @param probe scratch space, the positions are left in probe.candidates
+     */
+    void findCandidates(size_t position, Probe &probe) const;
+
+private:
+    static const uint32_t PRUNED = UINT32_MAX; // Marks a set in Probe::overlaps that can no longer qualify
+
+    // Tolerance when rounding bounds, so floating point error can only ever keep a pair
+    static constexpr const double BOUND_SLACK = 1e-6;
+
+    // A prefix element of a set: where the set is and where the element is within it
+    struct Posting {
+        uint32_t position;
+        uint32_t elementPosition;
+    };
+
+    double similarityThreshold;
+    vector<uint32_t> elements;       // Every set as element ranks, rarest first
+    vector<size_t> setOffsets;       // Set i is elements[setOffsets[i], setOffsets[i + 1])
+    vector<Posting> postings;        // Posting list of each rank, by ascending position
+    vector<size_t> postingOffsets;   // Rank r's list is postings[postingOffsets[r], postingOffsets[r + 1])
+
+    // Number of elements in the set at a position
+    size_t setSize(size_t position) const;
+
+    // First position whose set is at least this large
+    size_t firstPositionOfSize(size_t minimumSize) const;
+
+    // Number of leading elements of a set that must share an element with any similar set
+    size_t prefixLength(size_t setSize) const;
+
+    // Smallest whole number above the bound, rounded down when in doubt
+    static size_t smallestAbove(double bound);
+};
+
+
+#endif //CODESMELLDETECTOR_PREFIXFILTERINDEX_H
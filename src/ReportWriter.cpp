@@ -0,0 +1,341 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "ReportWriter.h"
+#include "CodeSmellDetector.h"
+#include <cctype>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+    const char *LONG_METHOD_RULE = "long-method";
+    const char *LONG_PARAMETER_LIST_RULE = "long-parameter-list";
+    const char *DUPLICATED_CODE_RULE = "duplicated-code";
+
+    const char *SARIF_HEADER =
+            "{\"version\":\"2.1.0\",\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\",\"runs\":[{"
+            "\"tool\":{\"driver\":{\"name\":\"CodeSmellDetector\",\"rules\":["
+            "{\"id\":\"long-method\",\"name\":\"LongMethod\","
+            "\"shortDescription\":{\"text\":\"Function has too many lines of code\"}},"
+            "{\"id\":\"long-parameter-list\",\"name\":\"LongParameterList\","
+            "\"shortDescription\":{\"text\":\"Function takes too many parameters\"}},"
+            "{\"id\":\"duplicated-code\",\"name\":\"DuplicatedCode\","
+            "\"shortDescription\":{\"text\":\"Function is nearly identical to another function\"}}"
+            "]}},\n\"results\":[\n";
+
+    // SARIF locations are URI references, so anything outside the unreserved set is escaped
+    string toUri(const string &path) {
+        static const char HEX_DIGITS[] = "0123456789ABCDEF";
+        string uri;
+        for (char c : path) {
+            unsigned char byte = static_cast<unsigned char>(c);
+            if (isalnum(byte) || c == '/' || c == '.' || c == '_' || c == '-' || c == '~') {
+                uri += c;
+            } else {
+                uri += '%';
+                uri += HEX_DIGITS[byte >> 4];
+                uri += HEX_DIGITS[byte & 0xf];
+            }
+        }
+        return uri;
+    }
+}
+
+ReportWriter::ReportWriter(Format format, const string &outputPath) {
+    this->format = format;
+    this->writeFailed = false;
+    this->wroteRecord = false;
+
+    if (outputPath == "-") {
+        this->output = stdout;
+        this->ownsOutput = false;
+    } else {
+        this->output = fopen(outputPath.c_str(), "w");
+        this->ownsOutput = true;
+        if (this->output == nullptr) {
+            throw invalid_argument("error opening output file: [" + outputPath + "]");
+        }
+    }
+
+    buffer.reserve(BUFFER_SIZE);
+    if (format == SARIF) {
+        buffer += SARIF_HEADER;
+    }
+}
+
+ReportWriter::~ReportWriter() {
+    close();
+}
+
+bool ReportWriter::parseFormat(const string &name, Format &format) {
+    if (name == "text") {
+        format = TEXT;
+    } else if (name == "jsonl") {
+        format = JSON_LINES;
+    } else if (name == "sarif") {
+        format = SARIF;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+string ReportWriter::renderFile(const string &filename, const AnalysisSummary &summary) const {
+    const vector<AnalysisSummary::FunctionMetrics> &functions = summary.getFunctions();
+    string records;
+
+    for (uint32_t index : summary.getLongMethodFunctions()) {
+        const AnalysisSummary::FunctionMetrics &function = functions[index];
+        renderRecord(records, filename, LONG_METHOD_RULE, function.name,
+                     function.firstLineNumber, function.lastLineNumber,
+                     ",\"lineCount\":" + to_string(function.lineCount),
+                     "The " + function.name + " function is a " +
+                     CodeSmellDetector::smellTypeToString(CodeSmellDetector::LONG_METHOD) +
+                     ". It contains " + to_string(function.lineCount) + " lines of code.");
+    }
+
+    for (uint32_t index : summary.getLongParameterListFunctions()) {
+        const AnalysisSummary::FunctionMetrics &function = functions[index];
+        renderRecord(records, filename, LONG_PARAMETER_LIST_RULE, function.name,
+                     function.firstLineNumber, function.lastLineNumber,
+                     ",\"parameterCount\":" + to_string(function.parameterCount),
+                     "The " + function.name + " function has a " +
+                     CodeSmellDetector::smellTypeToString(CodeSmellDetector::LONG_PARAMETER_LIST) +
+                     ". It contains " + to_string(function.parameterCount) + " parameters.");
+    }
+
+    // A group of exact clones is one result, located at its first function
+    for (const vector<uint32_t> &group : summary.getCloneGroups()) {
+        const AnalysisSummary::FunctionMetrics &first = functions[group.front()];
+
+        string fields = ",\"clones\":[";
+        string names = first.name;
+        for (size_t i = 1; i < group.size(); i++) {
+            const AnalysisSummary::FunctionMetrics &clone = functions[group[i]];
+            fields += i == 1 ? "{\"function\":" : ",{\"function\":";
+            appendJsonString(fields, clone.name);
+            fields += ",\"line\":" + to_string(clone.firstLineNumber) + "}";
+            names += (i + 1 == group.size() ? " and " : ", ") + clone.name;
+        }
+        fields += "]";
+
+        renderRecord(records, filename, DUPLICATED_CODE_RULE, first.name,
+                     first.firstLineNumber, first.lastLineNumber, fields,
+                     "The functions " + names + " are exact clones, identical apart from whitespace and comments.");
+    }
+
+    for (const AnalysisSummary::DuplicatePair &pair : summary.getDuplicatePairs()) {
+        const AnalysisSummary::FunctionMetrics &first = functions[pair.firstFunction];
+        const AnalysisSummary::FunctionMetrics &second = functions[pair.secondFunction];
+
+        string fields = ",\"otherFunction\":";
+        appendJsonString(fields, second.name);
+        fields += ",\"otherFile\":";
+        appendJsonString(fields, filename);
+        fields += ",\"otherLine\":" + to_string(second.firstLineNumber);
+        fields += ",\"similarity\":" + formatDecimal(pair.similarityIndex, 4);
+
+        renderRecord(records, filename, DUPLICATED_CODE_RULE, first.name,
+                     first.firstLineNumber, first.lastLineNumber, fields,
+                     "The functions " + first.name + " and " + second.name + " are duplicated. " +
+                     "The Jaccard similarity percentage is " + formatDecimal(pair.similarityIndex * 100, 2) + "%.");
+    }
+
+    // A clone region is one result, located at the lines of its first copy
+    for (const CodeSmellDetector::CloneRegion &region : summary.getCloneRegions()) {
+        const CodeSmellDetector::RegionLocation &first = region.locations.front();
+
+        string fields = ",\"tokenCount\":" + to_string(region.tokenCount) + ",\"copies\":[";
+        string copies;
+        for (size_t i = 0; i < region.locations.size(); i++) {
+            const CodeSmellDetector::RegionLocation &location = region.locations[i];
+            const AnalysisSummary::FunctionMetrics &function = functions[location.functionIndex];
+            fields += i == 0 ? "{\"function\":" : ",{\"function\":";
+            appendJsonString(fields, function.name);
+            fields += ",\"firstLine\":" + to_string(location.firstLineNumber);
+            fields += ",\"lastLine\":" + to_string(location.lastLineNumber) + "}";
+            copies += i == 0 ? "" : (i + 1 == region.locations.size() ? " and " : ", ");
+            copies += "lines " + to_string(location.firstLineNumber) + "-" + to_string(location.lastLineNumber) +
+                      " of " + function.name;
+        }
+        fields += "]";
+
+        renderRecord(records, filename, DUPLICATED_CODE_RULE, functions[first.functionIndex].name,
+                     first.firstLineNumber, first.lastLineNumber, fields,
+                     "The same " + to_string(region.tokenCount) + " tokens appear in " + copies + ".");
+    }
+
+    size_t omittedCount = summary.getOmittedDuplicateCount();
+    if (omittedCount > 0 && format == JSON_LINES) {
+        records += "{\"file\":";
+        appendJsonString(records, filename);
+        records += ",\"omittedDuplicates\":" + to_string(omittedCount) + "}\n";
+    } else if (omittedCount > 0 && format == SARIF) {
+        omittedDuplicateCount += omittedCount;
+    }
+
+    return records;
+}
+
+string ReportWriter::renderCrossFileDuplicates(const GlobalFunctionIndex &globalIndex,
+                                               const vector<GlobalFunctionIndex::CrossFileDuplicate> &duplicates) const {
+    string records;
+
+    for (const GlobalFunctionIndex::CrossFileDuplicate &duplicate : duplicates) {
+        string firstFile = globalIndex.getFilename(duplicate.firstFunction);
+        string firstName = globalIndex.getFunctionName(duplicate.firstFunction);
+        string secondFile = globalIndex.getFilename(duplicate.secondFunction);
+        string secondName = globalIndex.getFunctionName(duplicate.secondFunction);
+        size_t firstLineNumber = globalIndex.getFirstLineNumber(duplicate.firstFunction);
+        size_t lastLineNumber = globalIndex.getLastLineNumber(duplicate.firstFunction);
+
+        string fields = ",\"otherFunction\":";
+        appendJsonString(fields, secondName);
+        fields += ",\"otherFile\":";
+        appendJsonString(fields, secondFile);
+        fields += ",\"otherLine\":" + to_string(globalIndex.getFirstLineNumber(duplicate.secondFunction));
+        fields += ",\"similarity\":" + formatDecimal(duplicate.similarityIndex, 4);
+
+        renderRecord(records, firstFile, DUPLICATED_CODE_RULE, firstName, firstLineNumber, lastLineNumber, fields,
+                     "The functions " + firstName + " and " + secondName + " (" + secondFile + ") are duplicated. " +
+                     "The Jaccard similarity percentage is " +
+                     formatDecimal(duplicate.similarityIndex * 100, 2) + "%.");
+    }
+
+    return records;
+}
+
+string ReportWriter::renderError(const string &filename, const string &message) {
+    if (format == SARIF) {
+        lock_guard<mutex> guard(errorLock);
+        errors.emplace_back(filename, message);
+        return "";
+    }
+
+    string record = "{\"file\":";
+    appendJsonString(record, filename);
+    record += ",\"error\":";
+    appendJsonString(record, message);
+    record += "}\n";
+    return record;
+}
+
+void ReportWriter::write(string_view records) {
+    if (format == SARIF && !wroteRecord && !records.empty()) {
+        records.remove_prefix(1); // The first result needs no separator
+        wroteRecord = true;
+    }
+
+    buffer.append(records.data(), records.size());
+    if (buffer.size() >= BUFFER_SIZE) {
+        flush();
+    }
+}
+
+bool ReportWriter::close() {
+    if (output == nullptr) {
+        return !writeFailed;
+    }
+
+    if (format == SARIF) {
+        buffer += "\n],\"invocations\":[{\"executionSuccessful\":";
+        buffer += errors.empty() ? "true" : "false";
+        buffer += ",\"toolExecutionNotifications\":[";
+        for (size_t i = 0; i < errors.size(); i++) {
+            buffer += i == 0 ? "\n" : ",\n";
+            buffer += "{\"level\":\"error\",\"message\":{\"text\":";
+            appendJsonString(buffer, errors[i].second);
+            buffer += "},\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"uri\":";
+            appendJsonString(buffer, toUri(errors[i].first));
+            buffer += "}}}]}";
+        }
+        buffer += "]}]";
+        if (omittedDuplicateCount > 0) {
+            buffer += ",\"properties\":{\"omittedDuplicates\":" + to_string(omittedDuplicateCount) + "}";
+        }
+        buffer += "}]}\n";
+    }
+
+    flush();
+    if (ownsOutput && fclose(output) != 0) {
+        writeFailed = true;
+    }
+    output = nullptr;
+    return !writeFailed;
+}
+
+void ReportWriter::flush() {
+    if (!buffer.empty() && fwrite(buffer.data(), 1, buffer.size(), output) != buffer.size()) {
+        writeFailed = true;
+    }
+    if (fflush(output) != 0) {
+        writeFailed = true;
+    }
+    buffer.clear();
+}
+
+void ReportWriter::renderRecord(string &records, const string &filename, const char *ruleId,
+                                const string &functionName, size_t firstLineNumber, size_t lastLineNumber,
+                                const string &jsonFields, const string &message) const {
+    if (format == JSON_LINES) {
+        records += "{\"file\":";
+        appendJsonString(records, filename);
+        records += ",\"smell\":\"";
+        records += ruleId;
+        records += "\",\"function\":";
+        appendJsonString(records, functionName);
+        records += ",\"line\":" + to_string(firstLineNumber);
+        records += ",\"endLine\":" + to_string(lastLineNumber);
+        records += jsonFields;
+        records += ",\"message\":";
+        appendJsonString(records, message);
+        records += "}\n";
+    } else if (format == SARIF) {
+        records += ",\n{\"ruleId\":\"";
+        records += ruleId;
+        records += "\",\"level\":\"warning\",\"message\":{\"text\":";
+        appendJsonString(records, message);
+        records += "},\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"uri\":";
+        appendJsonString(records, toUri(filename));
+        records += "},\"region\":{\"startLine\":" + to_string(firstLineNumber);
+        records += ",\"endLine\":" + to_string(lastLineNumber) + "}}}]";
+        records += ",\"properties\":{\"function\":";
+        appendJsonString(records, functionName);
+        records += jsonFields;
+        records += "}}";
+    }
+}
+
+void ReportWriter::appendJsonString(string &out, string_view text) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    out += '"';
+    for (char c : text) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else if (c == '\t') {
+            out += "\\t";
+        } else if (c == '\r') {
+            out += "\\r";
+        } else if (byte < 0x20) {
+            out += "\\u00";
+            out += HEX_DIGITS[byte >> 4];
+            out += HEX_DIGITS[byte & 0xf];
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+string ReportWriter::formatDecimal(double value, int digits) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return text;
+}
@@ -0,0 +1,128 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_REPORTWRITER_H
+#define CODESMELLDETECTOR_REPORTWRITER_H
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "AnalysisSummary.h"
+#include "GlobalFunctionIndex.h"
+
+using namespace std;
+
+/**
+ * Streams the results of a batch scan to stdout or a file, as plain text, JSON Lines (one
+ * JSON object per code smell) or a SARIF 2.1.0 log. Records for a file are rendered on the
+ * worker that analyzed it, then written in path order as soon as they are ready, so the
+ * output is usable before the scan finishes and nothing is held back for the whole run.
+ * Writes go through a fixed size buffer that is flushed whenever it fills up.
+ */
+class ReportWriter {
+public:
+    enum Format {
+        TEXT,       // Human readable report, rendered by the caller
+        JSON_LINES, // One object per line, no enclosing document
+        SARIF       // A single SARIF log whose results array is written incrementally
+    };
+
+    static const size_t BUFFER_SIZE = 64 * 1024;
+
+    /**
+     * Open the output and write the start of the document, if the format has one
+     * @param format output format
+     * @param outputPath file to write, or "-" for stdout
+     * @throws invalid_argument if the file cannot be opened
+     */
+    ReportWriter(Format format, const string &outputPath);
+
+    /**
+     * Finish the document and close the output, if close() has not been called
+     */
+    ~ReportWriter();
+
+    ReportWriter(const ReportWriter &) = delete;
+    ReportWriter &operator=(const ReportWriter &) = delete;
+
+    /**
+     * Parse a format name
+     * @param name "text", "jsonl" or "sarif"
+     * @param format set to the format
+     * @return true if the name is known, false if not
+     */
+    static bool parseFormat(const string &name, Format &format);
+
+    /**
+     * Render the code smells of one file as records. Duplicated pairs left out by the
+     * duplicate limit are counted: JSON Lines gets a record with the count for the file,
+     * SARIF gets the total in the run's properties. Thread safe.
+     * @param filename path of the file
+     * @param summary analysis results of the file
+     * @return records to pass to write()
+     */
+    string renderFile(const string &filename, const AnalysisSummary &summary) const;
+
+    /**
+     * Render the Duplicated Code found between files. Thread safe.
+     * @param globalIndex index the duplicates were found in
+     * @param duplicates pairs to render
+     * @return records to pass to write()
+     */
+    string renderCrossFileDuplicates(const GlobalFunctionIndex &globalIndex,
+                                     const vector<GlobalFunctionIndex::CrossFileDuplicate> &duplicates) const;
+
+    /**
+     * Report a file that could not be analyzed. JSON Lines gets an error record, SARIF
+     * lists the error in the run's invocation once the log is finished. Thread safe.
+     * @param filename path of the file
+     * @param message what went wrong
+     * @return records to pass to write()
+     */
+    string renderError(const string &filename, const string &message);
+
+    /**
+     * Append rendered records (or text) to the output. Not thread safe, call from one thread.
+     * @param records output of one of the render methods
+     */
+    void write(string_view records);
+
+    /**
+     * Write out everything buffered so far, for output that must show up as soon as it is ready
+     */
+    void flush();
+
+    /**
+     * Finish the document, flush and close the output
+     * @return true if everything was written, false if a write failed
+     */
+    bool close();
+
+private:
+    Format format;
+    FILE *output;
+    bool ownsOutput;
+    bool writeFailed;
+    bool wroteRecord; // SARIF: a result was written, the next one needs a separator
+    string buffer;
+
+    mutable atomic<size_t> omittedDuplicateCount{0}; // SARIF: reported when the log is finished
+
+    mutex errorLock;
+    vector<pair<string, string>> errors; // SARIF: files that failed, reported when the log is finished
+
+    // One record per smell; SARIF records start with a separator the first write() drops
+    void renderRecord(string &records, const string &filename, const char *ruleId, const string &functionName,
+                      size_t firstLineNumber, size_t lastLineNumber, const string &jsonFields,
+                      const string &message) const;
+
+    static void appendJsonString(string &out, string_view text);
+    static string formatDecimal(double value, int digits);
+};
+
+
+#endif //CODESMELLDETECTOR_REPORTWRITER_H
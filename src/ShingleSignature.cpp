@@ -0,0 +1,96 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "ShingleSignature.h"
+#include "Tokenizer.h"
+#include "Hash.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+ShingleSignature::ShingleSignature() = default;
+
+ShingleSignature::ShingleSignature(Span<uint32_t> tokens, size_t shingleSize, bool normalizeNames,
+                                   pmr::memory_resource *arena)
+        : shingles(arena) {
+    if (shingleSize == 0) {
+        throw invalid_argument("shingle size must be positive");
+    }
+
+    addRollingShingles(tokens, min(shingleSize, tokens.size()), normalizeNames);
+
+    sort(shingles.begin(), shingles.end());
+    shingles.erase(unique(shingles.begin(), shingles.end()), shingles.end());
+}
+
+size_t ShingleSignature::count() const {
+    return shingles.size();
+}
+
+Span<uint64_t> ShingleSignature::getShingles() const {
+    return shingles;
+}
+
+void ShingleSignature::intersectionAndUnionCounts(const ShingleSignature &first, const ShingleSignature &second,
+                                                  size_t &intersectionCount, size_t &unionCount) {
+    intersectionAndUnionCounts(first.getShingles(), second.getShingles(), intersectionCount, unionCount);
+}
+
+void ShingleSignature::intersectionAndUnionCounts(Span<uint64_t> a, Span<uint64_t> b,
+                                                  size_t &intersectionCount, size_t &unionCount) {
+
+    // Merge walk over the two sorted sets
+    intersectionCount = 0;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (b[j] < a[i]) {
+            j++;
+        } else {
+            intersectionCount++;
+            i++;
+            j++;
+        }
+    }
+
+    unionCount = a.size() + b.size() - intersectionCount;
+}
+
+void ShingleSignature::addRollingShingles(Span<uint32_t> tokens, size_t shingleSize, bool normalizeNames) {
+    if (shingleSize == 0) {
+        return;
+    }
+
+    // Weight of the token that leaves the window: ROLLING_BASE^(shingleSize - 1)
+    uint64_t outgoingWeight = 1;
+    for (size_t i = 1; i < shingleSize; i++) {
+        outgoingWeight *= ROLLING_BASE;
+    }
+
+    // Exact size up front, growing in an arena would strand every outgrown buffer
+    if (tokens.size() >= shingleSize) {
+        shingles.reserve(tokens.size() - shingleSize + 1);
+    }
+
+    // Token IDs are small, so each is mixed into a full 64-bit value before it enters the window
+    auto tokenValue = [normalizeNames](uint32_t token) {
+        return Hash::mix(normalizeNames ? Tokenizer::normalizeToken(token) : token);
+    };
+
+    uint64_t windowHash = 0;
+    for (size_t i = 0; i < tokens.size(); i++) {
+        if (i >= shingleSize) {
+            windowHash -= tokenValue(tokens[i - shingleSize]) * outgoingWeight;
+        }
+        windowHash = windowHash * ROLLING_BASE + tokenValue(tokens[i]);
+
+        if (i + 1 >= shingleSize) {
+            // The polynomial hash is linear, so mix it before it is used as a set element
+            shingles.push_back(Hash::mix(windowHash));
+        }
+    }
+}
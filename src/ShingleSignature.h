@@ -0,0 +1,85 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_SHINGLESIGNATURE_H
+#define CODESMELLDETECTOR_SHINGLESIGNATURE_H
+
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+#include "Span.h"
+
+using namespace std;
+
+/**
+ * The set of token k-grams (shingles) in a piece of code. Each shingle is a Rabin-Karp
+ * rolling hash over k consecutive token IDs from Tokenizer::lexTokens(), so building the set
+ * is a single pass over the tokens. Unlike character sets, shingle sets keep token order, so two functions are
+ * only similar if they share many short runs of identical code.
+ */
+class ShingleSignature {
+public:
+    static const size_t DEFAULT_SHINGLE_SIZE = 5;
+
+    /**
+     * Initialize an empty signature
+     */
+    ShingleSignature();
+
+    /**
+     * Build the shingle set of lexed code. Code with fewer than shingleSize tokens gets a single
+     * shingle covering all of its tokens.
+     * @param tokens token IDs of the code
+     * @param shingleSize number of tokens per shingle
+     * @param normalizeNames compare identifiers and literals by their class only, see Tokenizer::normalizeToken()
+     * @param arena memory the shingle set is allocated from
+     * @throws invalid_argument if shingleSize is 0
+     */
+    ShingleSignature(Span<uint32_t> tokens, size_t shingleSize, bool normalizeNames,
+                     pmr::memory_resource *arena = pmr::get_default_resource());
+
+    /**
+     * Get the number of distinct shingles
+     * @return set size
+     */
+    size_t count() const;
+
+    /**
+     * Get the shingle hashes
+     * @return sorted list of distinct shingle hashes
+     */
+    Span<uint64_t> getShingles() const;
+
+    /**
+     * Count the shingles in both sets and in either set
+     * @param first first signature
+     * @param second second signature
+     * @param intersectionCount set to the size of the intersection
+     * @param unionCount set to the size of the union
+     */
+    static void intersectionAndUnionCounts(const ShingleSignature &first, const ShingleSignature &second,
+                                           size_t &intersectionCount, size_t &unionCount);
+
+    /**
+     * Same as above, for shingle sets stored elsewhere
+     * @param first sorted list of distinct shingle hashes
+     * @param second sorted list of distinct shingle hashes
+     * @param intersectionCount set to the size of the intersection
+     * @param unionCount set to the size of the union
+     */
+    static void intersectionAndUnionCounts(Span<uint64_t> first, Span<uint64_t> second,
+                                           size_t &intersectionCount, size_t &unionCount);
+
+private:
+    static const uint64_t ROLLING_BASE = 0x100000001b3ULL; // Odd, so powers never vanish mod 2^64
+
+    pmr::vector<uint64_t> shingles;
+
+    // Slide a window of shingleSize tokens over the token IDs (arithmetic is mod 2^64)
+    void addRollingShingles(Span<uint32_t> tokens, size_t shingleSize, bool normalizeNames);
+};
+
+
+#endif //CODESMELLDETECTOR_SHINGLESIGNATURE_H
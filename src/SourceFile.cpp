@@ -0,0 +1,85 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "SourceFile.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+SourceFile::SourceFile() {
+    this->data = nullptr;
+    this->size = 0;
+}
+
+SourceFile::~SourceFile() {
+    close();
+}
+
+bool SourceFile::open(const string &filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        ::close(fd);
+        return false;
+    }
+
+    // mmap rejects empty mappings, and an empty file simply has no lines
+    if (info.st_size > 0) {
+        void *mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+
+        madvise(mapping, info.st_size, MADV_SEQUENTIAL);
+        this->data = static_cast<const char *>(mapping);
+        this->size = info.st_size;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+    indexLines();
+    return true;
+}
+
+const vector<string_view> &SourceFile::getLines() const {
+    return lines;
+}
+
+string_view SourceFile::getContents() const {
+    return string_view(data, size);
+}
+
+void SourceFile::close() {
+    if (data != nullptr) {
+        munmap(const_cast<char *>(data), size);
+    }
+
+    data = nullptr;
+    size = 0;
+    lines.clear();
+}
+
+void SourceFile::indexLines() {
+    const char *lineStart = data;
+    const char *end = data + size;
+
+    while (lineStart < end) {
+        const char *newline = static_cast<const char *>(memchr(lineStart, '\n', end - lineStart));
+        const char *lineEnd = newline != nullptr ? newline : end;
+
+        lines.emplace_back(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+    }
+}
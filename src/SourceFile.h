@@ -0,0 +1,64 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_SOURCEFILE_H
+#define CODESMELLDETECTOR_SOURCEFILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+/**
+ * A source file mapped read-only into memory, plus an index of where each line starts and
+ * ends. Lines are handed out as string_views into the mapping, so the file contents are
+ * never copied. Everything holding such a view must not outlive the SourceFile.
+ */
+class SourceFile {
+public:
+    /**
+     * Initialize an empty source file with no lines
+     */
+    SourceFile();
+
+    /**
+     * Unmap the file
+     */
+    ~SourceFile();
+
+    SourceFile(const SourceFile &) = delete;
+    SourceFile &operator=(const SourceFile &) = delete;
+
+    /**
+     * Map the file and index its lines. Line breaks are '\n'; a trailing '\r' stays part of
+     * the line, the same as getline.
+     * @param filename path of the file
+     * @return true if the file could be read, false if not
+     */
+    bool open(const string &filename);
+
+    /**
+     * Get the lines of the file
+     * @return views of every line, without the line break
+     */
+    const vector<string_view> &getLines() const;
+
+    /**
+     * Get the whole file contents
+     * @return view of the mapped file
+     */
+    string_view getContents() const;
+
+private:
+    const char *data;
+    size_t size;
+    vector<string_view> lines;
+
+    void close();
+    void indexLines();
+};
+
+
+#endif //CODESMELLDETECTOR_SOURCEFILE_H
@@ -0,0 +1,46 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_SPAN_H
+#define CODESMELLDETECTOR_SPAN_H
+
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Read-only view of a contiguous array, like string_view but for any element type. Does not
+ * own the elements; whatever holds them must outlive the span.
+ */
+template <typename T>
+class Span {
+public:
+    typedef const T *iterator;
+
+    Span() : elements(nullptr), count(0) {}
+
+    Span(const T *elements, size_t count) : elements(elements), count(count) {}
+
+    template <typename Allocator>
+    Span(const vector<T, Allocator> &list) : elements(list.data()), count(list.size()) {}
+
+    const T *data() const { return elements; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    const T &operator[](size_t index) const { return elements[index]; }
+    const T &front() const { return elements[0]; }
+    const T &back() const { return elements[count - 1]; }
+
+    iterator begin() const { return elements; }
+    iterator end() const { return elements + count; }
+
+private:
+    const T *elements;
+    size_t count;
+};
+
+
+#endif //CODESMELLDETECTOR_SPAN_H
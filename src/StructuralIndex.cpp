@@ -0,0 +1,131 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "StructuralIndex.h"
+#include <stdexcept>
+
+#if defined(__x86_64__)
+#define CODESMELLDETECTOR_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+    const char STRUCTURAL_CHARS[] = {'{', '}', '(', ')', ';', '/', '"', '\'', '\\', '\n'};
+    const size_t STRUCTURAL_CHAR_COUNT = sizeof(STRUCTURAL_CHARS);
+
+    typedef size_t (*IndexKernel)(const char *text, size_t size, vector<uint32_t> &positions);
+
+    bool isStructuralChar(char character) {
+        for (char structural : STRUCTURAL_CHARS) {
+            if (character == structural) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Index from start to the end of the text one byte at a time
+    void scalarTail(const char *text, size_t start, size_t size, vector<uint32_t> &positions) {
+        for (size_t i = start; i < size; i++) {
+            if (isStructuralChar(text[i])) {
+                positions.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+
+    // Turn the set bits of a block mask into positions
+    void appendMaskPositions(uint32_t mask, size_t blockStart, vector<uint32_t> &positions) {
+        while (mask != 0) {
+            positions.push_back(static_cast<uint32_t>(blockStart + __builtin_ctz(mask)));
+            mask &= mask - 1;
+        }
+    }
+
+    // Each kernel returns how many bytes it indexed, the rest is left to scalarTail
+    size_t scalarIndex(const char *, size_t, vector<uint32_t> &) {
+        return 0;
+    }
+
+#ifdef CODESMELLDETECTOR_X86
+    __attribute__((target("sse2")))
+    size_t sse2Index(const char *text, size_t size, vector<uint32_t> &positions) {
+        const size_t blockSize = 16;
+        __m128i structural[STRUCTURAL_CHAR_COUNT];
+        for (size_t i = 0; i < STRUCTURAL_CHAR_COUNT; i++) {
+            structural[i] = _mm_set1_epi8(STRUCTURAL_CHARS[i]);
+        }
+
+        size_t blockStart = 0;
+        for (; blockStart + blockSize <= size; blockStart += blockSize) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + blockStart));
+            __m128i matches = _mm_setzero_si128();
+            for (size_t i = 0; i < STRUCTURAL_CHAR_COUNT; i++) {
+                matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, structural[i]));
+            }
+            appendMaskPositions(static_cast<uint32_t>(_mm_movemask_epi8(matches)), blockStart, positions);
+        }
+        return blockStart;
+    }
+
+    __attribute__((target("avx2")))
+    size_t avx2Index(const char *text, size_t size, vector<uint32_t> &positions) {
+        const size_t blockSize = 32;
+        __m256i structural[STRUCTURAL_CHAR_COUNT];
+        for (size_t i = 0; i < STRUCTURAL_CHAR_COUNT; i++) {
+            structural[i] = _mm256_set1_epi8(STRUCTURAL_CHARS[i]);
+        }
+
+        size_t blockStart = 0;
+        for (; blockStart + blockSize <= size; blockStart += blockSize) {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text + blockStart));
+            __m256i matches = _mm256_setzero_si256();
+            for (size_t i = 0; i < STRUCTURAL_CHAR_COUNT; i++) {
+                matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, structural[i]));
+            }
+            appendMaskPositions(static_cast<uint32_t>(_mm256_movemask_epi8(matches)), blockStart, positions);
+        }
+        return blockStart;
+    }
+#endif
+
+    struct Kernel {
+        IndexKernel index;
+        const char *name;
+    };
+
+    // Pick the widest kernel the CPU supports, once
+    Kernel selectKernel() {
+#ifdef CODESMELLDETECTOR_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return Kernel{avx2Index, "avx2"};
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return Kernel{sse2Index, "sse2"};
+        }
+#endif
+        return Kernel{scalarIndex, "scalar"};
+    }
+
+    const Kernel SELECTED_KERNEL = selectKernel();
+}
+
+StructuralIndex::StructuralIndex(string_view text) {
+    if (text.size() > UINT32_MAX) {
+        throw invalid_argument("file too large to index");
+    }
+
+    size_t indexedBytes = SELECTED_KERNEL.index(text.data(), text.size(), positions);
+    scalarTail(text.data(), indexedBytes, text.size(), positions);
+}
+
+const vector<uint32_t> &StructuralIndex::getPositions() const {
+    return positions;
+}
+
+const char *StructuralIndex::kernelName() {
+    return SELECTED_KERNEL.name;
+}
@@ -0,0 +1,47 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_STRUCTURALINDEX_H
+#define CODESMELLDETECTOR_STRUCTURALINDEX_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Positions of every structural character in a block of text: curly brackets, parentheses,
+ * semicolons, forward slashes, quotes, backslashes and newlines. These are the only
+ * characters the Parser state machine reacts to, so it can jump from one to the next
+ * instead of looking at every byte. The text is classified 32 (AVX2) or 16 (SSE2) bytes at
+ * a time into a bitmask of structural characters, with a scalar fallback for other CPUs.
+ */
+class StructuralIndex {
+public:
+    /**
+     * Index the text
+     * @param text block of text, at most 4 GiB
+     * @throws invalid_argument if the text is too large to index
+     */
+    explicit StructuralIndex(string_view text);
+
+    /**
+     * Get the structural character positions
+     * @return offsets into the text, in increasing order
+     */
+    const vector<uint32_t> &getPositions() const;
+
+    /**
+     * Name of the kernel picked for this CPU ("avx2", "sse2" or "scalar")
+     * @return kernel name
+     */
+    static const char *kernelName();
+
+private:
+    vector<uint32_t> positions;
+};
+
+
+#endif //CODESMELLDETECTOR_STRUCTURALINDEX_H
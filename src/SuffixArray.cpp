@@ -0,0 +1,245 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "SuffixArray.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+SuffixArray::SuffixArray(vector<uint32_t> text, uint32_t alphabetSize) {
+    if (text.empty() || text.back() != 0) {
+        throw invalid_argument("suffix array text must end with a 0");
+    }
+    for (size_t i = 0; i + 1 < text.size(); i++) {
+        if (text[i] == 0 || text[i] >= alphabetSize) {
+            throw invalid_argument("suffix array symbol out of range: [" + to_string(text[i]) + "]");
+        }
+    }
+
+    this->text = move(text);
+    suffixes.resize(this->text.size());
+    buildSuffixArray(this->text.data(), suffixes.data(), this->text.size(), alphabetSize);
+    buildLcp();
+}
+
+const vector<uint32_t> &SuffixArray::getSuffixes() const {
+    return suffixes;
+}
+
+const vector<uint32_t> &SuffixArray::getLcp() const {
+    return lcp;
+}
+
+void SuffixArray::forEachMaximalRepeat(size_t minLength, const RepeatHandler &handler) const {
+    minLength = max<size_t>(minLength, 1);
+
+    // LCP intervals still open, innermost last. A run of suffixes whose common prefix is longer
+    // than that of its neighbors is exactly the set of occurrences of a right maximal repeat.
+    struct Interval {
+        size_t length;
+        size_t first;
+    };
+    vector<Interval> openIntervals = {{0, 0}};
+
+    size_t count = suffixes.size();
+    for (size_t i = 1; i <= count; i++) {
+        size_t common = i < count ? lcp[i] : 0;
+        size_t first = i - 1;
+        while (common < openIntervals.back().length) {
+            Interval interval = openIntervals.back();
+            openIntervals.pop_back();
+            first = interval.first;
+
+            Span<uint32_t> positions(suffixes.data() + first, i - first);
+            if (interval.length >= minLength && isLeftMaximal(positions)) {
+                handler(interval.length, positions);
+            }
+        }
+        if (common > openIntervals.back().length) {
+            openIntervals.push_back(Interval{common, first});
+        }
+    }
+}
+
+void SuffixArray::buildSuffixArray(const uint32_t *text, uint32_t *suffixes, size_t length, uint32_t alphabetSize) {
+    if (length == 1) {
+        suffixes[0] = 0;
+        return;
+    }
+
+    // A position is S-type if its suffix is smaller than the next one, L-type if larger
+    vector<bool> sTypes(length, false);
+    sTypes[length - 1] = true;
+    for (size_t i = length - 1; i-- > 0;) {
+        sTypes[i] = text[i] < text[i + 1] || (text[i] == text[i + 1] && sTypes[i + 1]);
+    }
+
+    // Sort the LMS substrings: drop the LMS positions at the ends of their buckets and induce
+    vector<uint32_t> buckets;
+    findBuckets(text, length, alphabetSize, buckets, true);
+    fill(suffixes, suffixes + length, EMPTY);
+    for (size_t i = 1; i < length; i++) {
+        if (isLeftmostSType(sTypes, i)) {
+            suffixes[--buckets[text[i]]] = static_cast<uint32_t>(i);
+        }
+    }
+    induceLTypes(text, suffixes, length, alphabetSize, sTypes, buckets);
+    induceSTypes(text, suffixes, length, alphabetSize, sTypes, buckets);
+
+    size_t lmsCount = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (isLeftmostSType(sTypes, suffixes[i])) {
+            suffixes[lmsCount++] = suffixes[i];
+        }
+    }
+
+    // Name the sorted LMS substrings, equal ones alike. LMS positions are at least two apart,
+    // so position / 2 gives each its own slot behind the sorted list.
+    fill(suffixes + lmsCount, suffixes + length, EMPTY);
+    uint32_t nameCount = 0;
+    uint32_t previous = EMPTY;
+    for (size_t i = 0; i < lmsCount; i++) {
+        uint32_t position = suffixes[i];
+        bool differs = false;
+        for (size_t offset = 0;; offset++) {
+            if (previous == EMPTY || text[position + offset] != text[previous + offset]
+                || sTypes[position + offset] != sTypes[previous + offset]) {
+                differs = true;
+                break;
+            }
+            if (offset > 0 && (isLeftmostSType(sTypes, position + offset)
+                               || isLeftmostSType(sTypes, previous + offset))) {
+                break;
+            }
+        }
+        if (differs) {
+            nameCount++;
+            previous = position;
+        }
+        suffixes[lmsCount + position / 2] = nameCount - 1;
+    }
+
+    // The names in text order form the reduced text, kept at the back of the array
+    size_t last = length - 1;
+    for (size_t i = length; i-- > lmsCount;) {
+        if (suffixes[i] != EMPTY) {
+            suffixes[last--] = suffixes[i];
+        }
+    }
+    uint32_t *reducedText = suffixes + length - lmsCount;
+    uint32_t *reducedSuffixes = suffixes;
+
+    // Sort the LMS suffixes, by recursing only if some LMS substrings are equal
+    if (nameCount < lmsCount) {
+        buildSuffixArray(reducedText, reducedSuffixes, lmsCount, nameCount);
+    } else {
+        for (size_t i = 0; i < lmsCount; i++) {
+            reducedSuffixes[reducedText[i]] = static_cast<uint32_t>(i);
+        }
+    }
+
+    // Map the reduced suffixes back to positions, put them at their bucket ends and induce the rest
+    size_t lmsIndex = 0;
+    for (size_t i = 1; i < length; i++) {
+        if (isLeftmostSType(sTypes, i)) {
+            reducedText[lmsIndex++] = static_cast<uint32_t>(i);
+        }
+    }
+    for (size_t i = 0; i < lmsCount; i++) {
+        reducedSuffixes[i] = reducedText[reducedSuffixes[i]];
+    }
+    fill(suffixes + lmsCount, suffixes + length, EMPTY);
+
+    findBuckets(text, length, alphabetSize, buckets, true);
+    for (size_t i = lmsCount; i-- > 0;) {
+        uint32_t position = suffixes[i];
+        suffixes[i] = EMPTY;
+        suffixes[--buckets[text[position]]] = position;
+    }
+    induceLTypes(text, suffixes, length, alphabetSize, sTypes, buckets);
+    induceSTypes(text, suffixes, length, alphabetSize, sTypes, buckets);
+}
+
+void SuffixArray::findBuckets(const uint32_t *text, size_t length, uint32_t alphabetSize, vector<uint32_t> &buckets,
+                              bool end) {
+    buckets.assign(alphabetSize, 0);
+    for (size_t i = 0; i < length; i++) {
+        buckets[text[i]]++;
+    }
+
+    uint32_t total = 0;
+    for (uint32_t &bucket : buckets) {
+        uint32_t count = bucket;
+        total += count;
+        bucket = end ? total : total - count;
+    }
+}
+
+void SuffixArray::induceLTypes(const uint32_t *text, uint32_t *suffixes, size_t length, uint32_t alphabetSize,
+                               const vector<bool> &sTypes, vector<uint32_t> &buckets) {
+    findBuckets(text, length, alphabetSize, buckets, false);
+    for (size_t i = 0; i < length; i++) {
+        uint32_t position = suffixes[i];
+        if (position != EMPTY && position > 0 && !sTypes[position - 1]) {
+            suffixes[buckets[text[position - 1]]++] = position - 1;
+        }
+    }
+}
+
+void SuffixArray::induceSTypes(const uint32_t *text, uint32_t *suffixes, size_t length, uint32_t alphabetSize,
+                               const vector<bool> &sTypes, vector<uint32_t> &buckets) {
+    findBuckets(text, length, alphabetSize, buckets, true);
+    for (size_t i = length; i-- > 0;) {
+        uint32_t position = suffixes[i];
+        if (position != EMPTY && position > 0 && sTypes[position - 1]) {
+            suffixes[--buckets[text[position - 1]]] = position - 1;
+        }
+    }
+}
+
+bool SuffixArray::isLeftmostSType(const vector<bool> &sTypes, size_t position) {
+    return position != EMPTY && position > 0 && sTypes[position] && !sTypes[position - 1];
+}
+
+void SuffixArray::buildLcp() {
+    size_t length = text.size();
+    vector<uint32_t> ranks(length);
+    for (size_t i = 0; i < length; i++) {
+        ranks[suffixes[i]] = static_cast<uint32_t>(i);
+    }
+
+    // The common prefix shrinks by at most one from a suffix to the next one in text order
+    lcp.assign(length, 0);
+    size_t common = 0;
+    for (size_t position = 0; position < length; position++) {
+        if (ranks[position] == 0) {
+            common = 0;
+            continue;
+        }
+
+        size_t previous = suffixes[ranks[position] - 1];
+        while (position + common < length && previous + common < length
+               && text[position + common] == text[previous + common]) {
+            common++;
+        }
+        lcp[ranks[position]] = static_cast<uint32_t>(common);
+        common = common > 0 ? common - 1 : 0;
+    }
+}
+
+bool SuffixArray::isLeftMaximal(Span<uint32_t> positions) const {
+    // Nothing comes before the start of the text, which differs from every symbol
+    if (positions[0] == 0) {
+        return true;
+    }
+
+    uint32_t symbolBefore = text[positions[0] - 1];
+    for (uint32_t position : positions) {
+        if (position == 0 || text[position - 1] != symbolBefore) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,88 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_SUFFIXARRAY_H
+#define CODESMELLDETECTOR_SUFFIXARRAY_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "Span.h"
+
+using namespace std;
+
+/**
+ * Suffix array and LCP array of a sequence of integer symbols. The suffix array is built with
+ * SA-IS (Nong, Zhang and Chan) and the LCP array with Kasai's algorithm, both in linear time,
+ * so even a file with hundreds of thousands of tokens takes a few milliseconds.
+ *
+ * Every substring that repeats is the common prefix of a run of neighboring suffixes, so the
+ * repeats can be read off the LCP array in one more linear pass instead of comparing anything.
+ */
+class SuffixArray {
+public:
+    // Called with the length of a repeated substring and the start of each of its occurrences,
+    // in suffix order
+    typedef function<void(size_t length, Span<uint32_t> positions)> RepeatHandler;
+
+    /**
+     * Build the suffix array and LCP array of a text
+     * @param text symbols below alphabetSize, ending with a 0 that appears nowhere else
+     * @param alphabetSize one more than the largest symbol
+     * @throws invalid_argument if the text does not end with its only 0 or a symbol is out of range
+     */
+    SuffixArray(vector<uint32_t> text, uint32_t alphabetSize);
+
+    /**
+     * Get the suffixes in lexicographic order
+     * @return start position of each suffix
+     */
+    const vector<uint32_t> &getSuffixes() const;
+
+    /**
+     * Get the length of the common prefix of each suffix and the one before it in getSuffixes()
+     * @return LCP array, 0 for the first suffix
+     */
+    const vector<uint32_t> &getLcp() const;
+
+    /**
+     * Find the maximal repeats: substrings of at least minLength symbols that occur more than
+     * once and cannot be extended to either side without losing an occurrence
+     * @param minLength shortest repeat of interest, at least 1
+     * @param handler called once per maximal repeat, longer repeats before the shorter ones containing them
+     */
+    void forEachMaximalRepeat(size_t minLength, const RepeatHandler &handler) const;
+
+private:
+    static constexpr const uint32_t EMPTY = UINT32_MAX; // Slot of the suffix array not filled in yet
+
+    vector<uint32_t> text;
+    vector<uint32_t> suffixes;
+    vector<uint32_t> lcp;
+
+    // SA-IS on text[0, length), whose last symbol is its only 0, writing suffixes[0, length)
+    static void buildSuffixArray(const uint32_t *text, uint32_t *suffixes, size_t length, uint32_t alphabetSize);
+
+    // Start (or with end, one past the end) of each symbol's bucket in the suffix array
+    static void findBuckets(const uint32_t *text, size_t length, uint32_t alphabetSize, vector<uint32_t> &buckets,
+                            bool end);
+
+    // Induce the order of the L-type suffixes from the sorted S-type ones, then the other way around
+    static void induceLTypes(const uint32_t *text, uint32_t *suffixes, size_t length, uint32_t alphabetSize,
+                             const vector<bool> &sTypes, vector<uint32_t> &buckets);
+    static void induceSTypes(const uint32_t *text, uint32_t *suffixes, size_t length, uint32_t alphabetSize,
+                             const vector<bool> &sTypes, vector<uint32_t> &buckets);
+
+    // Is position a leftmost S-type position, an S-type symbol right after an L-type one?
+    static bool isLeftmostSType(const vector<bool> &sTypes, size_t position);
+
+    // Kasai's algorithm over the finished suffix array
+    void buildLcp();
+
+    // Do the occurrences differ in the symbol before them, so the repeat cannot grow to the left?
+    bool isLeftMaximal(Span<uint32_t> positions) const;
+};
+
+
+#endif //CODESMELLDETECTOR_SUFFIXARRAY_H
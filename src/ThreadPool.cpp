@@ -0,0 +1,154 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "ThreadPool.h"
+#include <utility>
+
+using namespace std;
+
+thread_local ThreadPool *ThreadPool::currentPool = nullptr;
+thread_local size_t ThreadPool::currentWorkerIndex = 0;
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = defaultThreadCount();
+    }
+
+    this->queuedTaskCount = 0;
+    this->unfinishedTaskCount = 0;
+    this->nextQueueIndex = 0;
+    this->stopping = false;
+
+    for (size_t i = 0; i < threadCount; i++) {
+        queues.emplace_back(new WorkQueue());
+    }
+
+    for (size_t i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(stateLock);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+
+    for (thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(function<void()> task) {
+    size_t queueIndex;
+    {
+        lock_guard<mutex> guard(stateLock);
+        unfinishedTaskCount++;
+        queuedTaskCount++; // Under the state lock so a worker about to sleep cannot miss it
+
+        if (currentPool == this) {
+            queueIndex = currentWorkerIndex;
+        } else {
+            queueIndex = nextQueueIndex;
+            nextQueueIndex = (nextQueueIndex + 1) % queues.size();
+        }
+    }
+
+    {
+        lock_guard<mutex> guard(queues[queueIndex]->lock);
+        queues[queueIndex]->tasks.push_back(move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    unique_lock<mutex> guard(stateLock);
+    allTasksDone.wait(guard, [this] { return unfinishedTaskCount == 0; });
+
+    if (firstError) {
+        exception_ptr error = firstError;
+        firstError = nullptr;
+        rethrow_exception(error);
+    }
+}
+
+size_t ThreadPool::defaultThreadCount() {
+    unsigned int hardwareThreads = thread::hardware_concurrency();
+    return hardwareThreads == 0 ? 1 : hardwareThreads;
+}
+
+void ThreadPool::workerLoop(size_t workerIndex) {
+    currentPool = this;
+    currentWorkerIndex = workerIndex;
+
+    while (true) {
+        function<void()> task;
+        if (popTask(workerIndex, task)) {
+            exception_ptr error;
+            try {
+                task();
+            } catch (...) {
+                error = current_exception();
+            }
+            finishTask(error);
+            continue;
+        }
+
+        unique_lock<mutex> guard(stateLock);
+        taskAvailable.wait(guard, [this] { return stopping || queuedTaskCount > 0; });
+        if (stopping && queuedTaskCount == 0) {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::popTask(size_t workerIndex, function<void()> &task) {
+    WorkQueue &ownQueue = *queues[workerIndex];
+    {
+        lock_guard<mutex> guard(ownQueue.lock);
+        if (!ownQueue.tasks.empty()) {
+            task = move(ownQueue.tasks.back());
+            ownQueue.tasks.pop_back();
+            queuedTaskCount--;
+            return true;
+        }
+    }
+
+    return stealTask(workerIndex, task);
+}
+
+bool ThreadPool::stealTask(size_t thiefIndex, function<void()> &task) {
+    size_t queueCount = queues.size();
+
+    for (size_t offset = 1; offset < queueCount; offset++) {
+        WorkQueue &victim = *queues[(thiefIndex + offset) % queueCount];
+        lock_guard<mutex> guard(victim.lock);
+
+        if (!victim.tasks.empty()) {
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queuedTaskCount--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::finishTask(exception_ptr error) {
+    bool allDone;
+    {
+        lock_guard<mutex> guard(stateLock);
+        if (error && !firstError) {
+            firstError = error;
+        }
+        unfinishedTaskCount--;
+        allDone = unfinishedTaskCount == 0;
+    }
+
+    if (allDone) {
+        allTasksDone.notify_all();
+    }
+}
@@ -0,0 +1,93 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_THREADPOOL_H
+#define CODESMELLDETECTOR_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Fixed size work-stealing thread pool. Every worker owns a task queue; a worker pops
+ * its newest task first and, once its own queue runs dry, steals the oldest task from
+ * another worker. A single expensive task therefore only ever occupies one worker while
+ * the rest of the queued work drains through the others.
+ */
+class ThreadPool {
+public:
+    /**
+     * Start the worker threads
+     * @param threadCount number of workers, 0 selects defaultThreadCount()
+     */
+    explicit ThreadPool(size_t threadCount = 0);
+
+    /**
+     * Finish all queued tasks, then join the worker threads
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * Queue a task. Tasks submitted from inside a worker go to that worker's own queue,
+     * all others are distributed round robin.
+     * @param task the work to run
+     */
+    void submit(function<void()> task);
+
+    /**
+     * Block until every submitted task has finished. Rethrows the first exception
+     * thrown by a task, if any.
+     */
+    void wait();
+
+    /**
+     * Number of hardware threads, or 1 if that cannot be determined
+     * @return default worker count
+     */
+    static size_t defaultThreadCount();
+
+private:
+    struct WorkQueue {
+        mutex lock;
+        deque<function<void()>> tasks;
+    };
+
+    vector<unique_ptr<WorkQueue>> queues;
+    vector<thread> workers;
+
+    mutex stateLock;
+    condition_variable taskAvailable;
+    condition_variable allTasksDone;
+    atomic<size_t> queuedTaskCount;   // Submitted but not yet picked up by a worker
+    size_t unfinishedTaskCount;       // Submitted but not yet finished (guarded by stateLock)
+    size_t nextQueueIndex;            // Round robin cursor for external submissions (guarded by stateLock)
+    bool stopping;
+    exception_ptr firstError;
+
+    // Identify the pool and queue of the calling thread, if it is one of our workers
+    static thread_local ThreadPool *currentPool;
+    static thread_local size_t currentWorkerIndex;
+
+    void workerLoop(size_t workerIndex);
+
+    // Pop from the back of our own queue, otherwise steal from the front of another queue
+    bool popTask(size_t workerIndex, function<void()> &task);
+    bool stealTask(size_t thiefIndex, function<void()> &task);
+
+    void finishTask(exception_ptr error);
+};
+
+
+#endif //CODESMELLDETECTOR_THREADPOOL_H
@@ -0,0 +1,137 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "Tokenizer.h"
+#include "Hash.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+using namespace std;
+
+namespace {
+    // Sorted, so a keyword's ID is its position found by binary search
+    const string_view KEYWORDS[] = {
+            "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case",
+            "catch", "char", "char16_t", "char32_t", "char8_t", "class", "co_await", "co_return", "co_yield",
+            "compl", "concept", "const", "const_cast", "consteval", "constexpr", "constinit", "continue",
+            "decltype", "default", "delete", "do", "double", "dynamic_cast", "else", "enum", "explicit", "export",
+            "extern", "false", "float", "for", "friend", "goto", "if", "inline", "int", "long", "mutable",
+            "namespace", "new", "noexcept", "not", "not_eq", "nullptr", "operator", "or", "or_eq", "private",
+            "protected", "public", "register", "reinterpret_cast", "requires", "return", "short", "signed",
+            "sizeof", "static", "static_assert", "static_cast", "struct", "switch", "template", "this",
+            "thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using",
+            "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq"
+    };
+}
+
+void Tokenizer::lexTokens(Span<string_view> lines, vector<uint32_t> &tokens, vector<uint32_t> &tokenLines) {
+    bool inBlockComment = false;
+
+    for (size_t lineIndex = 0; lineIndex < lines.size(); lineIndex++) {
+        string_view line = lines[lineIndex];
+        size_t index = 0;
+
+        while (index < line.size()) {
+            if (inBlockComment) {
+                size_t commentEnd = line.find("*/", index);
+                if (commentEnd == string_view::npos) {
+                    break;
+                }
+                inBlockComment = false;
+                index = commentEnd + 2;
+                continue;
+            }
+
+            char c = line[index];
+            char next = index + 1 < line.size() ? line[index + 1] : '\0';
+
+            if (isspace(static_cast<unsigned char>(c))) {
+                index++;
+            } else if (c == '/' && next == '/') {
+                break; // Rest of the line is a comment
+            } else if (c == '/' && next == '*') {
+                inBlockComment = true;
+                index += 2;
+            } else if (c == '"' || c == '\'') {
+                size_t end = skipLiteral(line, index);
+                tokens.push_back(nameId(line.substr(index, end - index), c == '"' ? STRING : CHARACTER));
+                index = end;
+            } else if (isIdentifierChar(c)) {
+                size_t end = index + 1;
+                while (end < line.size() && isIdentifierChar(line[end])) {
+                    end++;
+                }
+                tokens.push_back(wordId(line.substr(index, end - index)));
+                index = end;
+            } else {
+                tokens.push_back(FIRST_PUNCTUATION_ID + static_cast<unsigned char>(c));
+                index++;
+            }
+        }
+
+        tokenLines.resize(tokens.size(), static_cast<uint32_t>(lineIndex));
+    }
+}
+
+uint32_t Tokenizer::normalizeToken(uint32_t token) {
+    return token >= FIRST_NAME_ID ? token % 4 : token;
+}
+
+Span<uint32_t> Tokenizer::getBody(Span<uint32_t> tokens) {
+    uint32_t openingCurlyBracket = FIRST_PUNCTUATION_ID + static_cast<unsigned char>('{');
+    const uint32_t *bodyStart = find(tokens.begin(), tokens.end(), openingCurlyBracket);
+    return Span<uint32_t>(bodyStart, static_cast<size_t>(tokens.end() - bodyStart));
+}
+
+uint64_t Tokenizer::hashBody(Span<uint32_t> tokens) {
+    Span<uint32_t> body = getBody(tokens);
+    uint64_t hash = Hash::mix(body.size());
+    for (uint32_t token : body) {
+        hash = Hash::combine(hash, token);
+    }
+    return hash;
+}
+
+bool Tokenizer::isIdentifierChar(char c) {
+    return isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+uint64_t Tokenizer::hashToken(string_view token) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (char c : token) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+uint32_t Tokenizer::wordId(string_view word) {
+    if (isdigit(static_cast<unsigned char>(word[0]))) {
+        return nameId(word, NUMBER);
+    }
+
+    auto keyword = lower_bound(begin(KEYWORDS), end(KEYWORDS), word);
+    if (keyword != end(KEYWORDS) && *keyword == word) {
+        return FIRST_KEYWORD_ID + static_cast<uint32_t>(keyword - begin(KEYWORDS));
+    }
+    return nameId(word, IDENTIFIER);
+}
+
+uint32_t Tokenizer::nameId(string_view token, TokenClass tokenClass) {
+    uint32_t slot = static_cast<uint32_t>(hashToken(token) % NAME_SLOT_COUNT);
+    return FIRST_NAME_ID + slot * 4 + tokenClass;
+}
+
+size_t Tokenizer::skipLiteral(string_view line, size_t begin) {
+    char quote = line[begin];
+    size_t index = begin + 1;
+
+    while (index < line.size() && line[index] != quote) {
+        index += line[index] == '\\' ? 2 : 1;
+    }
+
+    // Unterminated literals end with the line
+    return index < line.size() ? index + 1 : line.size();
+}
@@ -0,0 +1,94 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_TOKENIZER_H
+#define CODESMELLDETECTOR_TOKENIZER_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "Span.h"
+
+using namespace std;
+
+/**
+ * Lexes lines of C++ code into a stream of integer token IDs. Identifiers, keywords and
+ * numbers are one token each, string and character literals are one token including their
+ * quotes, and every other non-blank character is a token of its own. Whitespace and
+ * comments are dropped.
+ *
+ * Keywords and punctuation have fixed IDs below FIRST_NAME_ID. An identifier or literal gets
+ * its ID from a hash of its text, so the same name has the same ID in every function and
+ * every file, and the lowest two bits of the ID hold its TokenClass. normalizeToken() maps it
+ * to the ID of its class, which lets renamed variables and changed literals (Type-2 clones)
+ * match without lexing the code again.
+ */
+class Tokenizer {
+public:
+    // Kinds of tokens normalizeToken() abstracts, also their normalized IDs
+    enum TokenClass {
+        IDENTIFIER, NUMBER, STRING, CHARACTER
+    };
+
+    // IDs from here on are identifiers and literals
+    static const uint32_t FIRST_NAME_ID = 512;
+
+    /**
+     * Lex the lines and append one ID per token
+     * @param lines source lines with comment lines kept, so a block comment is skipped from its
+     *              opening line on. Tokens never span lines except inside block comments.
+     * @param tokens output list of token IDs
+     * @param tokenLines output list parallel to tokens, index of the token's line in lines
+     */
+    static void lexTokens(Span<string_view> lines, vector<uint32_t> &tokens, vector<uint32_t> &tokenLines);
+
+    /**
+     * Replace an identifier or literal with its class, leave keywords and punctuation alone
+     * @param token ID from lexTokens()
+     * @return normalized token ID
+     */
+    static uint32_t normalizeToken(uint32_t token);
+
+    /**
+     * Get the body of a function, its tokens from the first opening curly bracket on. Two
+     * bodies are equal exactly when they only differ in whitespace and comments.
+     * @param tokens token IDs of a function, starting with its header
+     * @return view of the body's tokens within tokens
+     */
+    static Span<uint32_t> getBody(Span<uint32_t> tokens);
+
+    /**
+     * Hash the body of a function, equal bodies get the same hash. Different bodies can
+     * collide, so compare the bodies before treating two functions as clones.
+     * @param tokens token IDs of a function, starting with its header
+     * @return hash of the body's token sequence
+     */
+    static uint64_t hashBody(Span<uint32_t> tokens);
+
+private:
+    static const uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+    static const uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+    // Fixed IDs: the classes, then one per character, then one per keyword
+    static const uint32_t FIRST_PUNCTUATION_ID = CHARACTER + 1;
+    static const uint32_t FIRST_KEYWORD_ID = FIRST_PUNCTUATION_ID + 256;
+
+    // Distinct hashes an identifier or literal can map to, each with room for the four classes
+    static const uint32_t NAME_SLOT_COUNT = (UINT32_MAX - FIRST_NAME_ID) / 4;
+
+    static bool isIdentifierChar(char c);
+    static uint64_t hashToken(string_view token);
+
+    // ID of an identifier, number or keyword
+    static uint32_t wordId(string_view word);
+
+    // ID of an identifier or literal of the given class
+    static uint32_t nameId(string_view token, TokenClass tokenClass);
+
+    // Get the index one past the end of the literal starting at begin (at its opening quote)
+    static size_t skipLiteral(string_view line, size_t begin);
+};
+
+
+#endif //CODESMELLDETECTOR_TOKENIZER_H
@@ -0,0 +1,133 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "UnifiedDiff.h"
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+using namespace std;
+
+UnifiedDiff::UnifiedDiff(istream &in) {
+    string line;
+    string filename;      // File the hunks belong to, empty if it is deleted
+    bool inFile = false;
+    size_t oldRemaining = 0; // Lines of the current hunk still to come, on each side
+    size_t newRemaining = 0;
+    size_t newLineNumber = 0;
+
+    auto markChanged = [this, &filename](size_t lineNumber) {
+        if (filename.empty()) {
+            return;
+        }
+        vector<LineRange> &ranges = changedLines[filename];
+        if (!ranges.empty() && ranges.back().lastLineNumber + 1 >= lineNumber) {
+            ranges.back().lastLineNumber = max(ranges.back().lastLineNumber, lineNumber);
+        } else {
+            ranges.push_back(LineRange{lineNumber, lineNumber});
+        }
+    };
+
+    while (getline(in, line)) {
+        if (oldRemaining > 0 || newRemaining > 0) {
+            // Some tools strip the space off empty context lines
+            char kind = line.empty() ? ' ' : line[0];
+            if (kind == '+') {
+                markChanged(newLineNumber++);
+                newRemaining -= newRemaining > 0 ? 1 : 0;
+            } else if (kind == '-') {
+                markChanged(newLineNumber);
+                oldRemaining -= oldRemaining > 0 ? 1 : 0;
+            } else if (kind != '\\') { // "\ No newline at end of file" is not a line
+                newLineNumber++;
+                newRemaining -= newRemaining > 0 ? 1 : 0;
+                oldRemaining -= oldRemaining > 0 ? 1 : 0;
+            }
+        } else if (line.compare(0, 4, "+++ ") == 0) {
+            filename = parseNewFilename(line);
+            inFile = true;
+        } else if (line.compare(0, 3, "@@ ") == 0) {
+            size_t newStart;
+            if (!inFile || !parseHunkHeader(line, oldRemaining, newStart, newRemaining)) {
+                throw invalid_argument("malformed unified diff hunk: [" + line + "]");
+            }
+            // A hunk that adds nothing is numbered by the line before it
+            newLineNumber = newRemaining == 0 ? newStart + 1 : newStart;
+        }
+    }
+
+    mergeRanges();
+}
+
+vector<string> UnifiedDiff::getFilenames() const {
+    vector<string> filenames;
+    for (const pair<const string, vector<LineRange>> &file : changedLines) {
+        filenames.push_back(file.first);
+    }
+    return filenames;
+}
+
+const vector<LineRange> &UnifiedDiff::getChangedLines(const string &filename) const {
+    static const vector<LineRange> noChanges;
+    auto file = changedLines.find(filename);
+    return file == changedLines.end() ? noChanges : file->second;
+}
+
+bool UnifiedDiff::parseHunkHeader(const string &line, size_t &oldLength, size_t &newStart, size_t &newLength) {
+    // Either side's length is left out when it is 1
+    unsigned long oldStartValue, oldLengthValue = 1, newStartValue, newLengthValue = 1;
+    const char *text = line.c_str();
+    bool parsed = sscanf(text, "@@ -%lu,%lu +%lu,%lu", &oldStartValue, &oldLengthValue, &newStartValue,
+                         &newLengthValue) == 4
+                  || sscanf(text, "@@ -%lu +%lu,%lu", &oldStartValue, &newStartValue, &newLengthValue) == 3
+                  || sscanf(text, "@@ -%lu,%lu +%lu", &oldStartValue, &oldLengthValue, &newStartValue) == 3
+                  || sscanf(text, "@@ -%lu +%lu", &oldStartValue, &newStartValue) == 2;
+    if (!parsed) {
+        return false;
+    }
+
+    oldLength = oldLengthValue;
+    newStart = newStartValue;
+    newLength = newLengthValue;
+    return true;
+}
+
+string UnifiedDiff::parseNewFilename(const string &line) {
+    string path = line.substr(4);
+    size_t tabIndex = path.find('\t');
+    if (tabIndex != string::npos) {
+        path.erase(tabIndex);
+    }
+
+    if (path == "/dev/null") {
+        return "";
+    }
+    if (path.compare(0, 2, "b/") == 0) {
+        path.erase(0, 2);
+    }
+    while (path.compare(0, 2, "./") == 0) {
+        path.erase(0, 2);
+    }
+    return path;
+}
+
+void UnifiedDiff::mergeRanges() {
+    for (pair<const string, vector<LineRange>> &file : changedLines) {
+        vector<LineRange> &ranges = file.second;
+        sort(ranges.begin(), ranges.end(), [](const LineRange &first, const LineRange &second) {
+            return first.firstLineNumber < second.firstLineNumber;
+        });
+
+        size_t mergedCount = 0;
+        for (const LineRange &range : ranges) {
+            if (mergedCount > 0 && range.firstLineNumber <= ranges[mergedCount - 1].lastLineNumber + 1) {
+                ranges[mergedCount - 1].lastLineNumber = max(ranges[mergedCount - 1].lastLineNumber,
+                                                             range.lastLineNumber);
+            } else {
+                ranges[mergedCount++] = range;
+            }
+        }
+        ranges.resize(mergedCount);
+    }
+}
@@ -0,0 +1,59 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_UNIFIEDDIFF_H
+#define CODESMELLDETECTOR_UNIFIEDDIFF_H
+
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+#include "LineRange.h"
+
+using namespace std;
+
+/**
+ * The lines a unified diff (as written by diff -u or git diff) changes in the new version of
+ * each file. Added lines are changed lines. Removed lines leave nothing behind in the new
+ * version, so the line that now follows them counts as changed instead, which puts a removal
+ * inside a function body in that function. Files are named as in the +++ header, without the
+ * b/ prefix git adds; files the diff deletes are left out.
+ */
+class UnifiedDiff {
+public:
+    /**
+     * Read a whole diff
+     * @param in stream holding the diff
+     * @throws invalid_argument if a hunk header cannot be parsed or a hunk comes before any file header
+     */
+    explicit UnifiedDiff(istream &in);
+
+    /**
+     * Get the files with changed lines
+     * @return sorted paths
+     */
+    vector<string> getFilenames() const;
+
+    /**
+     * Get the changed lines of a file
+     * @param filename path as given in the diff
+     * @return sorted ranges that do not overlap, empty if the diff does not change the file
+     */
+    const vector<LineRange> &getChangedLines(const string &filename) const;
+
+private:
+    map<string, vector<LineRange>> changedLines;
+
+    // Parse "@@ -a,b +c,d @@", setting the start and length of the new side, and the length of the old side
+    static bool parseHunkHeader(const string &line, size_t &oldLength, size_t &newStart, size_t &newLength);
+
+    // Path from a +++ line, without the b/ prefix or a trailing timestamp ("" for /dev/null)
+    static string parseNewFilename(const string &line);
+
+    // Sort the ranges of every file and merge the ones that touch
+    void mergeRanges();
+};
+
+
+#endif //CODESMELLDETECTOR_UNIFIEDDIFF_H
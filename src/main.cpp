@@ -1,11 +1,30 @@
 #include <iostream>
 #include <string>
 #include <vector>
-#include <fstream>
 #include "CodeSmellDetector.h"
+#include "DetectorRegistry.h"
 #include <csignal>
+#include <fstream>
 #include <algorithm>
 #include <iomanip>
+#include <sstream>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sys/stat.h>
+#include "AnalysisCache.h"
+#include "AnalysisSummary.h"
+#include "BatchScanner.h"
+#include "FileWatcher.h"
+#include "GlobalFunctionIndex.h"
+#include "IncrementalAnalyzer.h"
+#include "MinHashIndex.h"
+#include "PhaseStats.h"
+#include "ReportWriter.h"
+#include "SourceFile.h"
+#include "UnifiedDiff.h"
 
 using namespace std;
 
@@ -14,46 +33,370 @@ const int LONG_PARAMETER_LIST_OPTION = 2;
 const int DUPLICATED_CODE_DETECTION_OPTION = 3;
 const int QUIT_OPTION = 4;
 
+// Settings taken from the command line
+struct CommandLineOptions {
+    vector<string> paths;
+    size_t threadCount = 0;
+    DetectorConfig detectorConfig;
+    bool reportLshRecall = false;
+    string cacheDirectory; // Empty if results are not cached
+    string diffPath;       // Unified diff whose changed functions are analyzed, "-" for stdin, empty for whole files
+    bool findCrossFileDuplicates = false;
+    bool batch = false; // Never show the interactive menu
+    bool watch = false; // Stay resident and re-analyze files as they are saved
+    ReportWriter::Format outputFormat = ReportWriter::TEXT;
+    string outputPath = "-";
+    bool printStats = false;
+    PhaseStats::OutputFormat statsFormat = PhaseStats::TABLE;
+};
+
+// State shared by all workers of a batch scan
+struct BatchState {
+    AnalysisCache *cache = nullptr;             // Null if results are not cached
+    GlobalFunctionIndex *globalIndex = nullptr; // Null unless looking for duplicates across files
+    const UnifiedDiff *diff = nullptr;          // Null unless only changed functions are analyzed
+    ReportWriter *writer = nullptr;
+
+    atomic<size_t> failedFileCount{0};
+    atomic<size_t> exactDuplicateCount{0};
+    atomic<size_t> exactComparedPairCount{0};
+    atomic<size_t> lshDuplicateCount{0};
+    atomic<size_t> lshComparedPairCount{0};
+    mutex predictionLock;
+    double predictedLshDuplicateCount = 0; // Guarded by predictionLock
+};
+
 void printIntro();
-bool fillFileContents(vector<string> &fileContents, const string &filename);
+void printUsage(const string &programName);
+bool writesRecordsToStdout(const CommandLineOptions &options);
+bool parseArguments(int argc, char *argv[], CommandLineOptions &options);
+bool parseCount(const string &text, size_t &count);
 bool invalidFileExtension(const string &filename);
-void run(const CodeSmellDetector &codeSmellDetector);
+bool isDirectory(const string &path);
+unique_ptr<AnalysisCache> openCache(const CommandLineOptions &options);
+void printCacheStatistics(const AnalysisCache *cache, ostream &out = cout);
+int runInteractive(const string &filename, const CommandLineOptions &options);
+int runBatch(const CommandLineOptions &options);
+int runWatch(const CommandLineOptions &options);
+vector<string> directoriesToWatch(const vector<string> &paths, const vector<string> &filenames);
+string parentDirectory(const string &filename);
+void reanalyzeFile(const string &filename, const CommandLineOptions &options,
+                   map<string, IncrementalAnalyzer> &analyzers, ReportWriter &writer, ostream &status);
+bool openSourceFile(SourceFile &sourceFile, const string &filename);
+unique_ptr<UnifiedDiff> readDiff(const string &path);
+string withoutDotSlash(string path);
+AnalysisSummary summarizeFile(const SourceFile &sourceFile, const CommandLineOptions &options,
+                              AnalysisCache *cache);
+string analyzeFile(const string &filename, const CommandLineOptions &options, BatchState &state);
+string indexCorpusFile(const string &filename, const CommandLineOptions &options, BatchState &state);
+vector<GlobalFunctionIndex::CrossFileDuplicate> crossFileDuplicatesToReport(const GlobalFunctionIndex &globalIndex,
+                                                                            const UnifiedDiff *diff);
+void printCrossFileDuplicates(const GlobalFunctionIndex &globalIndex,
+                              const vector<GlobalFunctionIndex::CrossFileDuplicate> &duplicates, ostream &out);
+
+void printLshRecall(size_t lshCount, size_t exactCount, double predictedCount, size_t lshPairs, size_t exactPairs,
+                    ostream &out);
+// The menu and the printers take an AnalysisSummary, or in the interactive menu a CodeSmellDetector
+// whose duplicate scan may still be running; both have the same getters
+template <typename Results>
+void run(const Results &results, const DetectorConfig &config);
 void displayMainMenu();
 string selectMenuOption();
 bool isValidOption(const string &userInput);
 
-void printFunctionNames(const vector<string> &functionNames);
-void printLongMethodInfo(const CodeSmellDetector &codeSmellDetector);
-void printLongParameterListInfo(const CodeSmellDetector &codeSmellDetector);
-void printDuplicatedCodeInfo(const CodeSmellDetector &codeSmellDetector);
+void printReport(const AnalysisSummary &summary, const DetectorConfig &config, ostream &out);
+void printFunctionNames(const vector<string_view> &functionNames, ostream &out = cout);
+template <typename Results>
+void printLongMethodInfo(const Results &results, ostream &out = cout);
+template <typename Results>
+void printLongParameterListInfo(const Results &results, ostream &out = cout);
+template <typename Results>
+void printDuplicatedCodeInfo(const Results &results, ostream &out = cout);
+void printSmellNotLookedFor(CodeSmellDetector::SmellType type, ostream &out = cout);
 
 int main(int argc, char *argv[]) {
     // Handle error when resizing terminal window
     // Ok to just ignore signal
     signal(SIGWINCH, SIG_IGN);
 
-    printIntro();
+    CommandLineOptions options;
+    bool validArguments = parseArguments(argc, argv, options);
 
-    if (argc != 2) {
-        cerr << "usage: " << argv[0] << " " << "FILENAME" << endl;
+    // Nothing but records may go to stdout when a pipeline is reading them
+    if (!writesRecordsToStdout(options)) {
+        printIntro();
+    }
+
+    if (!validArguments) {
+        printUsage(argv[0]);
         return EXIT_FAILURE;
     }
 
-    string filename = argv[1];
+    if (options.printStats) {
+        PhaseStats::enable();
+    }
+
+    if (options.watch) {
+        // Files are analyzed one at a time, so a full pair scan can have every thread
+        options.detectorConfig.pairScanThreadCount = options.threadCount;
+        return runWatch(options);
+    }
+
+    // A single file keeps the interactive menu, anything else is scanned in parallel
+    bool interactive = !options.batch && options.outputFormat == ReportWriter::TEXT && options.outputPath == "-"
+                       && options.diffPath.empty();
+    if (interactive && options.paths.size() == 1 && !isDirectory(options.paths[0]) && !options.reportLshRecall) {
+        // Only one file, so its pair scan can have every thread
+        options.detectorConfig.pairScanThreadCount = options.threadCount;
+        return runInteractive(options.paths[0], options);
+    }
+
+    return runBatch(options);
+}
+
+void printIntro() {
+    cout << "Welcome to the Code Smell Detector program!" << endl;
+    cout << "By Francis Kogge" << endl;
+    cout << endl;
+}
+
+void printUsage(const string &programName) {
+    cerr << "usage: " << programName << " " << "[OPTIONS] FILENAME" << endl;
+    cerr << "       " << programName << " " << "[OPTIONS] PATH..." << endl;
+    cerr << endl;
+    cerr << "options:" << endl;
+    cerr << "  -j, --jobs N          number of worker threads (default: all cores)" << endl;
+    cerr << "  --smells LIST         code smells to look for, comma separated (default: all of them):" << endl;
+    cerr << "                        long-method, long-parameter-list, duplicated-code" << endl;
+    cerr << "  --similarity METRIC   similarity metric: char (default) or token" << endl;
+    cerr << "  --shingle-size K      tokens per shingle for the token metric (default: 5)" << endl;
+    cerr << "  --normalize-identifiers" << endl;
+    cerr << "                        let the token metric and clone regions match code with renamed identifiers" << endl;
+    cerr << "                        and changed literals" << endl;
+    cerr << "  --duplicates MODE     duplicate search: exact (default) or lsh" << endl;
+    cerr << "  --lsh-bands N         number of LSH bands (default: 20)" << endl;
+    cerr << "  --lsh-rows N          MinHash values per LSH band (default: 5)" << endl;
+    cerr << "  --lsh-recall          compare LSH results against exact mode and report the recall" << endl;
+    cerr << "  --top-duplicates K    only report the K most similar duplicated pairs of each file" << endl;
+    cerr << "  --top-duplicates-per-function K" << endl;
+    cerr << "                        only report the K most similar duplicated pairs of each function" << endl;
+    cerr << "  --group-clones        report functions that only differ in whitespace and comments as one group" << endl;
+    cerr << "  --clone-regions N     also report every run of at least N tokens that appears more than once" << endl;
+    cerr << "  --cross-file          also report Duplicated Code between functions in different files" << endl;
+    cerr << "  --batch               never show the interactive menu, even for a single file" << endl;
+    cerr << "  --watch               stay running and re-analyze files whenever they are saved" << endl;
+    cerr << "  --format FORMAT       batch output format: text (default), jsonl or sarif" << endl;
+    cerr << "  -o, --output FILE     write the batch output to FILE instead of stdout" << endl;
+    cerr << "  --cache DIR           reuse results for unchanged files across runs" << endl;
+    cerr << "  --diff FILE           only look for code smells in the functions a unified diff changes" << endl;
+    cerr << "                        (- reads it from stdin); PATHs are then only compared with --cross-file" << endl;
+    cerr << "  --stats[=FORMAT]      print time, items and allocations per phase: text (default) or json" << endl;
+}
+
+bool parseArguments(int argc, char *argv[], CommandLineOptions &options) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "-j" || arg == "--jobs") {
+            if (!hasValue || !parseCount(argv[++i], options.threadCount)) {
+                return false;
+            }
+        } else if (arg == "--smells") {
+            if (!hasValue) {
+                return false;
+            }
+            try {
+                options.detectorConfig.enabledSmells = DetectorRegistry::parseSmellList(argv[++i]);
+            } catch (const invalid_argument &e) {
+                cerr << e.what() << endl;
+                return false;
+            }
+        } else if (arg == "--similarity") {
+            string metric = hasValue ? argv[++i] : "";
+            if (metric == "char") {
+                options.detectorConfig.similarityMetric = DetectorConfig::CHARACTER;
+            } else if (metric == "token") {
+                options.detectorConfig.similarityMetric = DetectorConfig::TOKEN_SHINGLE;
+            } else {
+                return false;
+            }
+        } else if (arg == "--shingle-size") {
+            if (!hasValue || !parseCount(argv[++i], options.detectorConfig.shingleSize)) {
+                return false;
+            }
+        } else if (arg == "--normalize-identifiers") {
+            options.detectorConfig.normalizeIdentifiers = true;
+        } else if (arg == "--duplicates") {
+            string mode = hasValue ? argv[++i] : "";
+            if (mode == "exact") {
+                options.detectorConfig.duplicateSearch = DetectorConfig::EXACT;
+            } else if (mode == "lsh") {
+                options.detectorConfig.duplicateSearch = DetectorConfig::LSH;
+            } else {
+                return false;
+            }
+        } else if (arg == "--lsh-bands") {
+            if (!hasValue || !parseCount(argv[++i], options.detectorConfig.lshBandCount)) {
+                return false;
+            }
+        } else if (arg == "--lsh-rows") {
+            if (!hasValue || !parseCount(argv[++i], options.detectorConfig.lshRowsPerBand)) {
+                return false;
+            }
+        } else if (arg == "--lsh-recall") {
+            options.reportLshRecall = true;
+            options.detectorConfig.duplicateSearch = DetectorConfig::LSH;
+        } else if (arg == "--top-duplicates" || arg == "--top-duplicates-per-function") {
+            DetectorConfig &config = options.detectorConfig;
+            if (!hasValue || !parseCount(argv[++i], config.duplicateLimit) || config.duplicateLimit == 0) {
+                return false;
+            }
+            config.duplicateLimitScope = arg == "--top-duplicates" ? DetectorConfig::ALL_PAIRS
+                                                                   : DetectorConfig::PER_FUNCTION;
+        } else if (arg == "--group-clones") {
+            options.detectorConfig.groupExactClones = true;
+        } else if (arg == "--clone-regions") {
+            DetectorConfig &config = options.detectorConfig;
+            if (!hasValue || !parseCount(argv[++i], config.minCloneRegionTokens) || config.minCloneRegionTokens == 0) {
+                return false;
+            }
+        } else if (arg == "--cross-file") {
+            options.findCrossFileDuplicates = true;
+        } else if (arg == "--batch") {
+            options.batch = true;
+        } else if (arg == "--watch") {
+            options.watch = true;
+        } else if (arg == "--format") {
+            if (!hasValue || !ReportWriter::parseFormat(argv[++i], options.outputFormat)) {
+                return false;
+            }
+        } else if (arg == "-o" || arg == "--output") {
+            if (!hasValue) {
+                return false;
+            }
+            options.outputPath = argv[++i];
+        } else if (arg == "--stats" || arg == "--stats=text") {
+            options.printStats = true;
+            options.statsFormat = PhaseStats::TABLE;
+        } else if (arg == "--stats=json") {
+            options.printStats = true;
+            options.statsFormat = PhaseStats::JSON;
+        } else if (arg == "--diff") {
+            if (!hasValue) {
+                return false;
+            }
+            options.diffPath = argv[++i];
+        } else if (arg == "--cache") {
+            if (!hasValue) {
+                return false;
+            }
+            options.cacheDirectory = argv[++i];
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            cerr << "unknown option: " << arg << endl;
+            return false;
+        } else {
+            options.paths.push_back(arg);
+        }
+    }
+
+    // Both compare duplicated pairs, which are not looked for without Duplicated Code
+    if ((options.findCrossFileDuplicates || options.reportLshRecall)
+        && !DetectorRegistry::isEnabled(options.detectorConfig, CodeSmellDetector::DUPLICATED_CODE)) {
+        cerr << "--cross-file and --lsh-recall need duplicated-code in --smells" << endl;
+        return false;
+    }
+
+    // Watch mode keeps its own results per file and reports every update as it happens
+    if (options.watch && (options.outputFormat == ReportWriter::SARIF || options.findCrossFileDuplicates
+                          || options.reportLshRecall || !options.cacheDirectory.empty()
+                          || options.detectorConfig.duplicateSearch == DetectorConfig::LSH
+                          || options.detectorConfig.minCloneRegionTokens > 0)) {
+        cerr << "--watch cannot be combined with SARIF output, --cross-file, --cache, LSH or --clone-regions" << endl;
+        return false;
+    }
+
+    // The diff names the files to report, other paths only add functions to compare them with
+    if (!options.diffPath.empty() && (options.watch || options.reportLshRecall
+                                      || (!options.paths.empty() && !options.findCrossFileDuplicates))) {
+        cerr << "--diff cannot be combined with --watch or --lsh-recall, and takes PATHs only with --cross-file"
+             << endl;
+        return false;
+    }
+
+    return !options.paths.empty() || !options.diffPath.empty();
+}
+
+bool writesRecordsToStdout(const CommandLineOptions &options) {
+    return options.outputFormat != ReportWriter::TEXT && options.outputPath == "-";
+}
+
+bool parseCount(const string &text, size_t &count) {
+    if (text.empty() || text.find_first_not_of("0123456789") != string::npos) {
+        return false;
+    }
+
+    try {
+        count = stoul(text);
+    } catch (const exception &e) {
+        return false;
+    }
+    return true;
+}
+
+unique_ptr<AnalysisCache> openCache(const CommandLineOptions &options) {
+    if (options.cacheDirectory.empty()) {
+        return nullptr;
+    }
+    return unique_ptr<AnalysisCache>(new AnalysisCache(options.cacheDirectory, options.detectorConfig));
+}
+
+void printCacheStatistics(const AnalysisCache *cache, ostream &out) {
+    if (cache != nullptr) {
+        out << "Cache: " << cache->getHitCount() << " hit(s), " << cache->getMissCount() << " miss(es)." << endl;
+    }
+}
+
+int runInteractive(const string &filename, const CommandLineOptions &options) {
     if (invalidFileExtension(filename)) {
         cerr << "input file must have extension [.cpp]" << endl;
         return EXIT_FAILURE;
     }
 
-    vector<string> fileContents;
-    if(!fillFileContents(fileContents, filename)) {
+    SourceFile sourceFile;
+    if (!openSourceFile(sourceFile, filename)) {
         cerr << "error opening file: [" << filename << "]" << endl;
         return EXIT_FAILURE;
     }
 
     try {
-        CodeSmellDetector codeSmellDetector(fileContents);
-        run(codeSmellDetector);
+        unique_ptr<AnalysisCache> cache = openCache(options);
+        AnalysisSummary summary;
+        bool cached = false;
+        if (cache != nullptr) {
+            PHASE_SCOPE(CACHE);
+            PHASE_ITEMS(CACHE, 1);
+            cached = cache->load(sourceFile.getContents(), summary);
+        }
+
+        if (cached) {
+            run(summary, options.detectorConfig);
+        } else {
+            // The menu only waits for the parse, the duplicate scan runs until option 3 needs it
+            DetectorConfig config = options.detectorConfig;
+            config.backgroundDuplicateScan = true;
+            CodeSmellDetector codeSmellDetector(sourceFile.getLines(), config);
+            run(codeSmellDetector, options.detectorConfig);
+            if (cache != nullptr) {
+                AnalysisSummary fullSummary(codeSmellDetector);
+                PHASE_SCOPE(CACHE);
+                cache->store(sourceFile.getContents(), fullSummary);
+            }
+        }
+        printCacheStatistics(cache.get());
+        if (options.printStats) {
+            PhaseStats::print(cout, options.statsFormat);
+        }
     } catch (const std::exception &e) {
         cerr << e.what() << endl;
         return EXIT_FAILURE;
@@ -62,36 +405,444 @@ int main(int argc, char *argv[]) {
     return 0;
 }
 
-void printIntro() {
-    cout << "Welcome to the Code Smell Detector program!" << endl;
-    cout << "By Francis Kogge" << endl;
-    cout << endl;
+int runBatch(const CommandLineOptions &options) {
+    vector<string> filenames;
+    unique_ptr<UnifiedDiff> diff;
+    unique_ptr<AnalysisCache> cache;
+    unique_ptr<ReportWriter> writer;
+    try {
+        filenames = BatchScanner::collectSourceFiles(options.paths);
+        if (!options.diffPath.empty()) {
+            // Diffs name files relative to the top directory, so the same goes for the other paths
+            diff = readDiff(options.diffPath);
+            for (string &filename : filenames) {
+                filename = withoutDotSlash(filename);
+            }
+            for (const string &filename : diff->getFilenames()) {
+                if (BatchScanner::hasSourceExtension(filename)) {
+                    filenames.push_back(filename);
+                }
+            }
+            sort(filenames.begin(), filenames.end());
+            filenames.erase(unique(filenames.begin(), filenames.end()), filenames.end());
+        }
+        cache = openCache(options);
+        writer.reset(new ReportWriter(options.outputFormat, options.outputPath));
+    } catch (const std::exception &e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    // Progress and totals go wherever the records do not
+    ostream &status = writesRecordsToStdout(options) ? cerr : cout;
+
+    unique_ptr<GlobalFunctionIndex> globalIndex;
+    if (options.findCrossFileDuplicates) {
+        globalIndex.reset(new GlobalFunctionIndex(options.detectorConfig));
+    }
+
+    // A lone file gets every thread for its pair scan, otherwise the files are the unit of work
+    CommandLineOptions fileOptions = options;
+    if (filenames.size() == 1) {
+        fileOptions.detectorConfig.pairScanThreadCount = options.threadCount;
+    }
+
+    BatchState state;
+    state.cache = cache.get();
+    state.globalIndex = globalIndex.get();
+    state.diff = diff.get();
+    state.writer = writer.get();
+    BatchScanner scanner(options.threadCount);
+    scanner.scan(filenames,
+                 [&fileOptions, &state](const string &filename) {
+                     return analyzeFile(filename, fileOptions, state);
+                 },
+                 [&writer](const string &, const string &report) {
+                     writer->write(report);
+                 });
+
+    if (globalIndex) {
+        PHASE_SCOPE(RENDER_REPORT);
+        vector<GlobalFunctionIndex::CrossFileDuplicate> duplicates = crossFileDuplicatesToReport(*globalIndex,
+                                                                                               diff.get());
+        if (options.outputFormat == ReportWriter::TEXT) {
+            ostringstream report;
+            printCrossFileDuplicates(*globalIndex, duplicates, report);
+            writer->write(report.str());
+        } else {
+            writer->write(writer->renderCrossFileDuplicates(*globalIndex, duplicates));
+        }
+    }
+
+    bool outputWritten = writer->close();
+    if (!outputWritten) {
+        cerr << "error writing output: [" << options.outputPath << "]" << endl;
+    }
+
+    status << "Scanned " << filenames.size() << " file(s)";
+    if (state.failedFileCount > 0) {
+        status << ", " << state.failedFileCount << " could not be analyzed";
+    }
+    status << "." << endl;
+    printCacheStatistics(cache.get(), status);
+
+    if (options.reportLshRecall) {
+        status << "Overall: ";
+        printLshRecall(state.lshDuplicateCount, state.exactDuplicateCount, state.predictedLshDuplicateCount,
+                       state.lshComparedPairCount, state.exactComparedPairCount, status);
+    }
+
+    if (options.printStats) {
+        PhaseStats::print(status, options.statsFormat);
+    }
+
+    return state.failedFileCount > 0 || !outputWritten ? EXIT_FAILURE : 0;
 }
 
-bool invalidFileExtension(const string &filename) {
-    size_t dotIndex = filename.find_last_of('.');
-    return dotIndex == string::npos || filename.substr(dotIndex) != ".cpp";
+int runWatch(const CommandLineOptions &options) {
+    vector<string> filenames;
+    unique_ptr<ReportWriter> writer;
+    unique_ptr<FileWatcher> watcher;
+    try {
+        filenames = BatchScanner::collectSourceFiles(options.paths);
+        writer.reset(new ReportWriter(options.outputFormat, options.outputPath));
+        watcher.reset(new FileWatcher(directoriesToWatch(options.paths, filenames)));
+    } catch (const std::exception &e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    ostream &status = writesRecordsToStdout(options) ? cerr : cout;
+
+    // Only the files found at the start, plus new files in the directories given on the command line
+    vector<string> givenDirectories;
+    for (const string &path : options.paths) {
+        if (isDirectory(path)) {
+            givenDirectories.push_back(path.size() > 1 && path.back() == '/' ? path.substr(0, path.size() - 1) : path);
+        }
+    }
+    map<string, IncrementalAnalyzer> analyzers;
+    for (const string &filename : filenames) {
+        reanalyzeFile(filename, options, analyzers, *writer, status);
+    }
+    status << "Watching " << filenames.size() << " file(s) for changes, press Ctrl+C to stop." << endl;
+
+    while (true) {
+        vector<string> changedFiles;
+        try {
+            changedFiles = watcher->waitForChanges();
+        } catch (const std::exception &e) {
+            cerr << e.what() << endl;
+            return EXIT_FAILURE;
+        }
+
+        for (const string &filename : changedFiles) {
+            bool inGivenDirectory = find(givenDirectories.begin(), givenDirectories.end(),
+                                         parentDirectory(filename)) != givenDirectories.end();
+            if (analyzers.count(filename) > 0 || inGivenDirectory) {
+                reanalyzeFile(filename, options, analyzers, *writer, status);
+            }
+        }
+
+        if (options.printStats) {
+            PhaseStats::print(status, options.statsFormat);
+        }
+    }
+}
+
+vector<string> directoriesToWatch(const vector<string> &paths, const vector<string> &filenames) {
+    vector<string> directories;
+    for (const string &path : paths) {
+        if (isDirectory(path)) {
+            directories.push_back(path);
+        }
+    }
+    for (const string &filename : filenames) {
+        directories.push_back(parentDirectory(filename));
+    }
+
+    sort(directories.begin(), directories.end());
+    directories.erase(unique(directories.begin(), directories.end()), directories.end());
+    return directories;
 }
 
-bool fillFileContents(vector<string> &fileContents, const string &filename) {
-    ifstream inputFile;
-    inputFile.open(filename);
+string parentDirectory(const string &filename) {
+    size_t slashIndex = filename.find_last_of('/');
+    if (slashIndex == string::npos) {
+        return ".";
+    }
+    return slashIndex == 0 ? "/" : filename.substr(0, slashIndex);
+}
+
+void reanalyzeFile(const string &filename, const CommandLineOptions &options,
+                   map<string, IncrementalAnalyzer> &analyzers, ReportWriter &writer, ostream &status) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    bool textFormat = options.outputFormat == ReportWriter::TEXT;
+
+    SourceFile sourceFile;
+    if (!openSourceFile(sourceFile, filename)) {
+        status << "error opening file: [" << filename << "]" << endl;
+        return;
+    }
+
+    IncrementalAnalyzer &analyzer = analyzers.emplace(filename, IncrementalAnalyzer(options.detectorConfig))
+            .first->second;
+    ostringstream report;
+    try {
+        analyzer.update(sourceFile.getLines());
+        AnalysisSummary summary = analyzer.getSummary();
 
-    string line;
-    if (inputFile) {
-        while (getline(inputFile, line)) {
-            fileContents.push_back(line);
+        PHASE_SCOPE(RENDER_REPORT);
+        PHASE_ITEMS(RENDER_REPORT, 1);
+        if (textFormat) {
+            report << "==> " << filename << " <==" << endl;
+            printReport(summary, options.detectorConfig, report);
+            report << endl;
+        } else {
+            report << writer.renderFile(filename, summary);
+        }
+    } catch (const std::exception &e) {
+        // The previous results stay, the next save will most likely fix the file
+        if (textFormat) {
+            report << "==> " << filename << " <==" << endl << "error analyzing file: " << e.what() << endl << endl;
+        } else {
+            report << writer.renderError(filename, string("error analyzing file: ") + e.what());
         }
-    } else {
-        return false;
     }
+    writer.write(report.str());
+    writer.flush();
 
-    inputFile.close();
-    return true;
+    double milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    status << "Analyzed " << filename << " in " << setprecision(1) << fixed << milliseconds << " ms: "
+           << analyzer.getChangedFunctionCount() << " function(s) changed, "
+           << analyzer.getComparedPairCount() << " pair(s) compared." << endl;
 }
 
-void run(const CodeSmellDetector &codeSmellDetector) {
-    printFunctionNames(codeSmellDetector.getFunctionNames());
+AnalysisSummary summarizeFile(const SourceFile &sourceFile, const CommandLineOptions &options,
+                              AnalysisCache *cache) {
+    AnalysisSummary summary;
+    if (cache != nullptr) {
+        PHASE_SCOPE(CACHE);
+        PHASE_ITEMS(CACHE, 1);
+        if (cache->load(sourceFile.getContents(), summary)) {
+            return summary;
+        }
+    }
+
+    CodeSmellDetector codeSmellDetector(sourceFile.getLines(), options.detectorConfig);
+    summary = AnalysisSummary(codeSmellDetector);
+    if (cache != nullptr) {
+        PHASE_SCOPE(CACHE);
+        cache->store(sourceFile.getContents(), summary);
+    }
+    return summary;
+}
+
+unique_ptr<UnifiedDiff> readDiff(const string &path) {
+    if (path == "-") {
+        return unique_ptr<UnifiedDiff>(new UnifiedDiff(cin));
+    }
+
+    ifstream diffFile(path);
+    if (!diffFile) {
+        throw invalid_argument("error opening diff: [" + path + "]");
+    }
+    return unique_ptr<UnifiedDiff>(new UnifiedDiff(diffFile));
+}
+
+string withoutDotSlash(string path) {
+    while (path.compare(0, 2, "./") == 0) {
+        path.erase(0, path.find_first_not_of('/', 2));
+    }
+    return path;
+}
+
+bool openSourceFile(SourceFile &sourceFile, const string &filename) {
+    PHASE_SCOPE(READ_FILE);
+    bool opened = sourceFile.open(filename);
+    PHASE_ITEMS(READ_FILE, sourceFile.getLines().size());
+    return opened;
+}
+
+string analyzeFile(const string &filename, const CommandLineOptions &options, BatchState &state) {
+    const vector<LineRange> *changedLines = nullptr;
+    if (state.diff != nullptr) {
+        changedLines = &state.diff->getChangedLines(filename);
+        if (changedLines->empty()) {
+            return indexCorpusFile(filename, options, state);
+        }
+    }
+
+    bool textFormat = options.outputFormat == ReportWriter::TEXT;
+    ostringstream report;
+    if (textFormat) {
+        report << "==> " << filename << " <==" << endl;
+    }
+
+    SourceFile sourceFile;
+    if (!openSourceFile(sourceFile, filename)) {
+        state.failedFileCount++;
+        if (!textFormat) {
+            return state.writer->renderError(filename, "error opening file");
+        }
+        report << "error opening file: [" << filename << "]" << endl << endl;
+        return report.str();
+    }
+
+    try {
+        // Results for part of a file are not cached, they depend on the diff as well
+        AnalysisSummary summary;
+        if (changedLines == nullptr) {
+            summary = summarizeFile(sourceFile, options, state.cache);
+        } else {
+            CodeSmellDetector codeSmellDetector(sourceFile.getLines(), options.detectorConfig, *changedLines);
+            summary = AnalysisSummary(codeSmellDetector);
+        }
+        {
+            PHASE_SCOPE(RENDER_REPORT);
+            PHASE_ITEMS(RENDER_REPORT, 1);
+            if (textFormat) {
+                printReport(summary, options.detectorConfig, report);
+            } else {
+                report << state.writer->renderFile(filename, summary);
+            }
+        }
+
+        if (state.globalIndex != nullptr) {
+            PHASE_SCOPE(CROSS_FILE_INDEX);
+            PHASE_ITEMS(CROSS_FILE_INDEX, summary.getFunctions().size());
+            state.globalIndex->addFile(filename, summary);
+        }
+
+        if (options.reportLshRecall) {
+            DetectorConfig exactConfig = options.detectorConfig;
+            exactConfig.duplicateSearch = DetectorConfig::EXACT;
+            CodeSmellDetector exactDetector(sourceFile.getLines(), exactConfig);
+
+            // Each exact hit becomes an LSH candidate with a probability given by its similarity
+            MinHashIndex lshIndex(options.detectorConfig.lshBandCount, options.detectorConfig.lshRowsPerBand);
+            double predictedCount = 0;
+            for (const CodeSmellDetector::DuplicatedCode &occurrence : exactDetector.viewDuplicateCodeOccurrences()) {
+                predictedCount += lshIndex.candidateProbability(occurrence.similarityIndex);
+            }
+
+            size_t lshCount = summary.getDuplicatePairs().size();
+            size_t exactCount = exactDetector.viewDuplicateCodeOccurrences().size();
+            state.lshDuplicateCount += lshCount;
+            state.exactDuplicateCount += exactCount;
+            state.lshComparedPairCount += summary.getComparedPairCount();
+            state.exactComparedPairCount += exactDetector.getComparedPairCount();
+            {
+                lock_guard<mutex> guard(state.predictionLock);
+                state.predictedLshDuplicateCount += predictedCount;
+            }
+
+            if (textFormat) {
+                printLshRecall(lshCount, exactCount, predictedCount, summary.getComparedPairCount(),
+                               exactDetector.getComparedPairCount(), report);
+            }
+        }
+    } catch (const std::exception &e) {
+        state.failedFileCount++;
+        if (!textFormat) {
+            return state.writer->renderError(filename, string("error analyzing file: ") + e.what());
+        }
+        report << "error analyzing file: " << e.what() << endl;
+    }
+
+    if (textFormat) {
+        report << endl;
+    }
+    return report.str();
+}
+
+string indexCorpusFile(const string &filename, const CommandLineOptions &options, BatchState &state) {
+    // Only its functions are needed, to compare the changed functions of other files with
+    SourceFile sourceFile;
+    if (!openSourceFile(sourceFile, filename)) {
+        state.failedFileCount++;
+        return options.outputFormat == ReportWriter::TEXT
+               ? "==> " + filename + " <==\nerror opening file: [" + filename + "]\n\n"
+               : state.writer->renderError(filename, "error opening file");
+    }
+
+    try {
+        AnalysisSummary summary = summarizeFile(sourceFile, options, state.cache);
+        PHASE_SCOPE(CROSS_FILE_INDEX);
+        PHASE_ITEMS(CROSS_FILE_INDEX, summary.getFunctions().size());
+        state.globalIndex->addFile(filename, summary);
+    } catch (const std::exception &e) {
+        state.failedFileCount++;
+        string message = string("error analyzing file: ") + e.what();
+        return options.outputFormat == ReportWriter::TEXT ? "==> " + filename + " <==\n" + message + "\n\n"
+                                                          : state.writer->renderError(filename, message);
+    }
+    return "";
+}
+
+vector<GlobalFunctionIndex::CrossFileDuplicate> crossFileDuplicatesToReport(const GlobalFunctionIndex &globalIndex,
+                                                                            const UnifiedDiff *diff) {
+    vector<GlobalFunctionIndex::CrossFileDuplicate> duplicates = globalIndex.getDuplicates();
+    if (diff == nullptr) {
+        return duplicates;
+    }
+
+    // With a diff, only the pairs with a changed function
+    auto isChanged = [&globalIndex, diff](uint32_t functionId) {
+        return LineRange::anyOverlaps(diff->getChangedLines(globalIndex.getFilename(functionId)),
+                                      globalIndex.getFirstLineNumber(functionId),
+                                      globalIndex.getLastLineNumber(functionId));
+    };
+    duplicates.erase(remove_if(duplicates.begin(), duplicates.end(),
+                               [&isChanged](const GlobalFunctionIndex::CrossFileDuplicate &duplicate) {
+                                   return !isChanged(duplicate.firstFunction) && !isChanged(duplicate.secondFunction);
+                               }),
+                     duplicates.end());
+    return duplicates;
+}
+
+void printCrossFileDuplicates(const GlobalFunctionIndex &globalIndex,
+                              const vector<GlobalFunctionIndex::CrossFileDuplicate> &duplicates, ostream &out) {
+    out << "==> cross-file duplicates <==" << endl;
+
+    if (duplicates.empty()) {
+        out << "No functions in different files contain Duplicated Code!" << endl;
+    }
+
+    for (const GlobalFunctionIndex::CrossFileDuplicate &duplicate : duplicates) {
+        out << "The functions " << globalIndex.getFunctionName(duplicate.firstFunction)
+            << " (" << globalIndex.getFilename(duplicate.firstFunction) << ") and "
+            << globalIndex.getFunctionName(duplicate.secondFunction)
+            << " (" << globalIndex.getFilename(duplicate.secondFunction) << ")"
+            << " are duplicated. The Jaccard similarity percentage is "
+            << setprecision(2) << fixed << duplicate.similarityIndex * 100 << "%." // round 2 decimal places
+            << endl;
+    }
+    out << endl;
+}
+
+void printLshRecall(size_t lshCount, size_t exactCount, double predictedCount, size_t lshPairs, size_t exactPairs,
+                    ostream &out) {
+    // LSH hits are verified exactly, so they are always a subset of the exact hits
+    double recall = exactCount == 0 ? 1.0 : static_cast<double>(lshCount) / static_cast<double>(exactCount);
+    double predictedRecall = exactCount == 0 ? 1.0 : predictedCount / static_cast<double>(exactCount);
+    out << "LSH recall: " << lshCount << " of " << exactCount << " duplicated pairs found ("
+        << setprecision(2) << fixed << recall * 100 << "%, predicted " << predictedRecall * 100 << "%), "
+        << lshPairs << " of " << exactPairs << " pairs compared." << endl;
+}
+
+bool invalidFileExtension(const string &filename) {
+    return !BatchScanner::hasSourceExtension(filename);
+}
+
+bool isDirectory(const string &path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+template <typename Results>
+void run(const Results &results, const DetectorConfig &config) {
+    printFunctionNames(results.getFunctionNames());
 
     int option;
     string userInput;
@@ -105,11 +856,23 @@ void run(const CodeSmellDetector &codeSmellDetector) {
         option = stoi(userInput);
 
         if (option == LONG_METHOD_OPTION) {
-            printLongMethodInfo(codeSmellDetector);
+            if (DetectorRegistry::isEnabled(config, CodeSmellDetector::LONG_METHOD)) {
+                printLongMethodInfo(results);
+            } else {
+                printSmellNotLookedFor(CodeSmellDetector::LONG_METHOD);
+            }
         } else if (option == LONG_PARAMETER_LIST_OPTION) {
-            printLongParameterListInfo(codeSmellDetector);
+            if (DetectorRegistry::isEnabled(config, CodeSmellDetector::LONG_PARAMETER_LIST)) {
+                printLongParameterListInfo(results);
+            } else {
+                printSmellNotLookedFor(CodeSmellDetector::LONG_PARAMETER_LIST);
+            }
         } else if (option == DUPLICATED_CODE_DETECTION_OPTION) {
-            printDuplicatedCodeInfo(codeSmellDetector);
+            if (DetectorRegistry::isEnabled(config, CodeSmellDetector::DUPLICATED_CODE)) {
+                printDuplicatedCodeInfo(results);
+            } else {
+                printSmellNotLookedFor(CodeSmellDetector::DUPLICATED_CODE);
+            }
         }
     } while (option != QUIT_OPTION);
 }
@@ -166,57 +929,102 @@ bool isValidOption(const string &userInput) {
     return isValid;
 }
 
-void printFunctionNames(const vector<string> &functionNames) {
-    cout << "The file you provided contains the following methods: " << endl;
-    for (const string &name : functionNames) {
-        cout << "\t-> " << name << endl;
+void printReport(const AnalysisSummary &summary, const DetectorConfig &config, ostream &out) {
+    printFunctionNames(summary.getFunctionNames(), out);
+    if (DetectorRegistry::isEnabled(config, CodeSmellDetector::LONG_METHOD)) {
+        printLongMethodInfo(summary, out);
+    }
+    if (DetectorRegistry::isEnabled(config, CodeSmellDetector::LONG_PARAMETER_LIST)) {
+        printLongParameterListInfo(summary, out);
+    }
+    if (DetectorRegistry::isEnabled(config, CodeSmellDetector::DUPLICATED_CODE)) {
+        printDuplicatedCodeInfo(summary, out);
     }
 }
 
-void printLongMethodInfo(const CodeSmellDetector &codeSmellDetector) {
-    if (codeSmellDetector.hasLongMethodSmell()) {
-        vector<CodeSmellDetector::LongMethod> longMethodOccurrences =
-                codeSmellDetector.getLongMethodOccurrences();
+void printFunctionNames(const vector<string_view> &functionNames, ostream &out) {
+    out << "The file you provided contains the following methods: " << endl;
+    for (string_view name : functionNames) {
+        out << "\t-> " << name << endl;
+    }
+}
 
-        for (const CodeSmellDetector::LongMethod &longMethod : longMethodOccurrences) {
-            cout << "The " << longMethod.functionName
+template <typename Results>
+void printLongMethodInfo(const Results &results, ostream &out) {
+    if (results.hasLongMethodSmell()) {
+        CodeSmellDetector::OccurrenceVisitor visitor;
+        visitor.longMethod = [&out](const CodeSmellDetector::LongMethod &longMethod) {
+            out << "The " << longMethod.functionName
                  << " function is a " << CodeSmellDetector::smellTypeToString(longMethod.type)
                  << ". It contains " << longMethod.lineCount << " lines of code. "
                  << endl;
-        }
+        };
+        results.visitOccurrences(visitor);
     } else {
-        cout << "No function has Long Method!" << endl;
+        out << "No function has Long Method!" << endl;
     }
 }
 
-void printLongParameterListInfo(const CodeSmellDetector &codeSmellDetector) {
-    if (codeSmellDetector.hasLongParameterListSmell()) {
-        vector<CodeSmellDetector::LongParameterList> longParameterListOccurrences =
-                codeSmellDetector.getLongParameterListOccurrences();
-
-        for (const CodeSmellDetector::LongParameterList &occurrence : longParameterListOccurrences) {
-            cout << "The " << occurrence.functionName
+template <typename Results>
+void printLongParameterListInfo(const Results &results, ostream &out) {
+    if (results.hasLongParameterListSmell()) {
+        CodeSmellDetector::OccurrenceVisitor visitor;
+        visitor.longParameterList = [&out](const CodeSmellDetector::LongParameterList &occurrence) {
+            out << "The " << occurrence.functionName
                  << " function has a " << CodeSmellDetector::smellTypeToString(occurrence.type)
                  << ". It contains " << occurrence.parameterCount << " parameters. "
                  << endl;
-        }
+        };
+        results.visitOccurrences(visitor);
     } else {
-        cout << "No function has Long Parameter List!" << endl;
+        out << "No function has Long Parameter List!" << endl;
     }
 }
 
-void printDuplicatedCodeInfo(const CodeSmellDetector &codeSmellDetector) {
-    if (codeSmellDetector.hasDuplicateCodeSmell()) {
-        vector<CodeSmellDetector::DuplicatedCode> duplicatedCodeOccurrences =
-                codeSmellDetector.getDuplicateCodeOccurrences();
-
-        for (const CodeSmellDetector::DuplicatedCode &occurrence : duplicatedCodeOccurrences) {
-            cout << "The functions " << occurrence.functionNames.first << " and " << occurrence.functionNames.second
+template <typename Results>
+void printDuplicatedCodeInfo(const Results &results, ostream &out) {
+    if (results.hasDuplicateCodeSmell()) {
+        vector<string_view> functionNames = results.getFunctionNames();
+        CodeSmellDetector::OccurrenceVisitor visitor;
+        visitor.cloneGroup = [&out, &functionNames](Span<uint32_t> functionIndexes) {
+            out << "The functions ";
+            for (size_t i = 0; i < functionIndexes.size(); i++) {
+                if (i > 0) {
+                    out << (i + 1 == functionIndexes.size() ? " and " : ", ");
+                }
+                out << functionNames[functionIndexes[i]];
+            }
+            out << " are exact clones, identical apart from whitespace and comments." << endl;
+        };
+        visitor.duplicatedCode = [&out](const CodeSmellDetector::DuplicatedCode &occurrence) {
+            out << "The functions " << occurrence.functionNames.first << " and " << occurrence.functionNames.second
                  << " are duplicated. The Jaccard similarity percentage is "
                  << setprecision(2) << fixed << occurrence.similarityIndex * 100 << "%." // round 2 decimal places
                  << endl;
+        };
+        visitor.cloneRegion = [&out, &functionNames](size_t tokenCount,
+                                                     Span<CodeSmellDetector::RegionLocation> locations) {
+            out << "The same " << tokenCount << " tokens appear in ";
+            for (size_t i = 0; i < locations.size(); i++) {
+                if (i > 0) {
+                    out << (i + 1 == locations.size() ? " and " : ", ");
+                }
+                out << "lines " << locations[i].firstLineNumber << "-" << locations[i].lastLineNumber << " of "
+                    << functionNames[locations[i].functionIndex];
+            }
+            out << "." << endl;
+        };
+        results.visitOccurrences(visitor);
+
+        if (results.getOmittedDuplicateCount() > 0) {
+            out << results.getOmittedDuplicateCount() << " more pair(s) of functions are duplicated, "
+                << "only the most similar pairs are shown." << endl;
         }
     } else {
-        cout << "No functions contain Duplicated Code!" << endl;
+        out << "No functions contain Duplicated Code!" << endl;
     }
+}
+
+void printSmellNotLookedFor(CodeSmellDetector::SmellType type, ostream &out) {
+    out << CodeSmellDetector::smellTypeToString(type) << " was not looked for, see --smells." << endl;
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "TestSuite.h"
+#include "CodeSmellDetector.h"
+#include "DetectorConfig.h"
+#include <string_view>
+#include <vector>
+
+using namespace std;
+using TestSuite::check;
+
+namespace {
+    // The loop is the only shared code. It starts at the ';' ending the line before it, which
+    // comes after a block comment in f, and ends with the loop's closing bracket.
+    void testRegionLines() {
+        vector<string_view> lines = {
+                "int f(int a) {",
+                "    int s = a + 1;",
+                "    /* sum the doubled",
+                "     * numbers below a */",
+                "    for (int i = 0; i < a; i++) {",
+                "        s += i * 2;",
+                "    }",
+                "    return s;",
+                "}",
+                "void g(int a) {",
+                "    print(a);",
+                "    int s = 0;",
+                "    for (int i = 0; i < a; i++) {",
+                "        s += i * 2;",
+                "    }",
+                "    log(s);",
+                "}"
+        };
+        DetectorConfig config;
+        config.minCloneRegionTokens = 10;
+        CodeSmellDetector detector(lines, config);
+        vector<CodeSmellDetector::CloneRegion> regions = detector.getCloneRegionOccurrences();
+        check(regions.size() == 1, "one clone region");
+        if (regions.size() != 1 || regions[0].locations.size() != 2) {
+            return;
+        }
+
+        const CodeSmellDetector::RegionLocation &first = regions[0].locations[0];
+        const CodeSmellDetector::RegionLocation &second = regions[0].locations[1];
+        check(first.functionIndex == 0 && first.firstLineNumber == 2 && first.lastLineNumber == 7,
+              "the first copy is lines 2-7 of f");
+        check(second.functionIndex == 1 && second.firstLineNumber == 12 && second.lastLineNumber == 15,
+              "the second copy is lines 12-15 of g");
+    }
+}
+
+void TestSuite::runCloneRegionTests() {
+    testRegionLines();
+}
@@ -0,0 +1,84 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "TestSuite.h"
+#include "CodeSmellDetector.h"
+#include "CorpusGenerator.h"
+#include "DetectorConfig.h"
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+using TestSuite::check;
+
+namespace {
+    typedef tuple<size_t, size_t, double> Pair; // Function indexes and similarity index
+
+    vector<Pair> findDuplicates(const vector<string_view> &lines, DetectorConfig config, bool prune) {
+        config.pruneCandidatePairs = prune;
+        CodeSmellDetector detector(lines, config);
+
+        vector<Pair> pairs;
+        for (const CodeSmellDetector::DuplicatedCode &occurrence : detector.getDuplicateCodeOccurrences()) {
+            pairs.emplace_back(occurrence.functionIndexes.first, occurrence.functionIndexes.second,
+                               occurrence.similarityIndex);
+        }
+        return pairs;
+    }
+
+    // Pruning skips pairs whose sizes rule out a duplicate, so it must report exactly the pairs
+    // a scan of every pair reports, with the plain scan as well as the tiled one
+    void testPruningKeepsEveryPair() {
+        CorpusOptions options;
+        options.functionCount = 400;
+        options.duplicationRate = 0.3;
+        string contents = CorpusGenerator(options).generateFile(0);
+        vector<string_view> lines = TestSuite::splitLines(contents);
+
+        for (size_t threadCount : {1, 4}) {
+            DetectorConfig config;
+            config.pairScanThreadCount = threadCount;
+            vector<Pair> pruned = findDuplicates(lines, config, true);
+            vector<Pair> unpruned = findDuplicates(lines, config, false);
+            check(!unpruned.empty(), "the corpus has duplicated pairs");
+            check(pruned == unpruned, "size pruning reports the same pairs as the full scan, "
+                                      + to_string(threadCount) + " thread(s)");
+        }
+    }
+
+    // Under the token metric pruning also skips pairs that share none of their rarest shingles,
+    // which again must not lose a pair. Short bodies put edited copies close to the threshold,
+    // where a prefix one shingle too short starts missing pairs.
+    void testPrefixFilterKeepsEveryPair() {
+        CorpusOptions options;
+        options.functionCount = 300;
+        options.minLines = 3;
+        options.maxLines = 8;
+        options.duplicationRate = 0.3;
+        string contents = CorpusGenerator(options).generateFile(1);
+        vector<string_view> lines = TestSuite::splitLines(contents);
+
+        for (bool normalizeIdentifiers : {false, true}) {
+            for (size_t threadCount : {1, 4}) {
+                DetectorConfig config;
+                config.similarityMetric = DetectorConfig::TOKEN_SHINGLE;
+                config.normalizeIdentifiers = normalizeIdentifiers;
+                config.pairScanThreadCount = threadCount;
+                vector<Pair> pruned = findDuplicates(lines, config, true);
+                vector<Pair> unpruned = findDuplicates(lines, config, false);
+                check(!unpruned.empty(), "the corpus has duplicated pairs under the token metric");
+                check(pruned == unpruned, "the prefix filter reports the same pairs as the full scan, "
+                                          + to_string(threadCount) + " thread(s)"
+                                          + (normalizeIdentifiers ? ", normalized identifiers" : ""));
+            }
+        }
+    }
+}
+
+void TestSuite::runDuplicateScanTests() {
+    testPruningKeepsEveryPair();
+    testPrefixFilterKeepsEveryPair();
+}
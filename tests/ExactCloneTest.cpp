@@ -0,0 +1,58 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "TestSuite.h"
+#include "AnalysisSummary.h"
+#include "CodeSmellDetector.h"
+#include "DetectorConfig.h"
+#include "IncrementalAnalyzer.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+using TestSuite::check;
+
+namespace {
+    // Functions 0, 2 and 3 share a hash, but only 0 and 3 have the same body
+    void testCollidingHashesDoNotGroup() {
+        vector<uint64_t> bodyHashes = {7, 9, 7, 7, 9};
+        vector<int> bodies = {1, 2, 3, 1, 2};
+        vector<uint32_t> representatives = CodeSmellDetector::findCloneRepresentatives(
+                bodyHashes, [&bodies](uint32_t first, uint32_t second) { return bodies[first] == bodies[second]; });
+        check(representatives == vector<uint32_t>({0, 1, 2, 0, 1}),
+              "functions only group when their bodies match, not just their hashes");
+    }
+
+    // Through the detector and the incremental analyzer, which must agree
+    void testBodiesGroupWhenEqual() {
+        vector<string_view> lines = {
+                "int first(int a) { return a * 2 + 1; }",
+                "int second(int b) { return b * 2 + 1; }",
+                "int third(int a) {",
+                "    // same body as first",
+                "    return a * 2 + 1;",
+                "}",
+                "int fourth(int a) { return a * 2 - 1; }"
+        };
+        DetectorConfig config;
+        config.groupExactClones = true;
+        CodeSmellDetector detector(lines, config);
+        vector<CodeSmellDetector::CloneGroup> groups = detector.getCloneGroupOccurrences();
+        check(groups.size() == 1, "one exact clone group");
+        check(!groups.empty() && groups[0].functionIndexes == vector<size_t>({0, 2}),
+              "the group holds the functions with the same body");
+
+        IncrementalAnalyzer analyzer(config);
+        analyzer.update(lines);
+        AnalysisSummary summary = analyzer.getSummary();
+        check(summary.getCloneGroups() == vector<vector<uint32_t>>({{0, 2}}),
+              "the incremental analyzer finds the same group");
+    }
+}
+
+void TestSuite::runExactCloneTests() {
+    testCollidingHashesDoNotGroup();
+    testBodiesGroupWhenEqual();
+}
@@ -0,0 +1,48 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "TestSuite.h"
+#include <iostream>
+
+using namespace std;
+
+namespace {
+    size_t failureCount = 0;
+}
+
+void TestSuite::check(bool condition, const string &description) {
+    if (!condition) {
+        cout << "FAILED: " << description << endl;
+        failureCount++;
+    }
+}
+
+vector<string_view> TestSuite::splitLines(string_view text) {
+    vector<string_view> lines;
+    size_t lineStart = 0;
+    while (lineStart < text.size()) {
+        size_t lineEnd = text.find('\n', lineStart);
+        if (lineEnd == string_view::npos) {
+            lineEnd = text.size();
+        }
+        lines.push_back(text.substr(lineStart, lineEnd - lineStart));
+        lineStart = lineEnd + 1;
+    }
+    return lines;
+}
+
+int main() {
+    TestSuite::runTokenizerTests();
+    TestSuite::runDuplicateScanTests();
+    TestSuite::runExactCloneTests();
+    TestSuite::runUnifiedDiffTests();
+    TestSuite::runCloneRegionTests();
+
+    if (failureCount > 0) {
+        cout << failureCount << " check(s) failed" << endl;
+        return 1;
+    }
+    cout << "All tests passed" << endl;
+    return 0;
+}
@@ -0,0 +1,42 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#ifndef CODESMELLDETECTOR_TESTSUITE_H
+#define CODESMELLDETECTOR_TESTSUITE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+/**
+ * The checks run by "make test". Every test file adds a run function that checks its
+ * expectations with check(); TestMain.cpp runs all of them and fails if any check did.
+ */
+namespace TestSuite {
+    /**
+     * Count and print a failed expectation
+     * @param condition true if the expectation holds
+     * @param description what was expected, printed if it does not hold
+     */
+    void check(bool condition, const string &description);
+
+    /**
+     * Split text into lines the way SourceFile does, without the line breaks
+     * @param text file contents, must outlive the lines
+     * @return views of every line
+     */
+    vector<string_view> splitLines(string_view text);
+
+    // One per test file
+    void runTokenizerTests();
+    void runDuplicateScanTests();
+    void runExactCloneTests();
+    void runUnifiedDiffTests();
+    void runCloneRegionTests();
+}
+
+
+#endif //CODESMELLDETECTOR_TESTSUITE_H
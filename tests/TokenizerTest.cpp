@@ -0,0 +1,78 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "TestSuite.h"
+#include "CodeSmellDetector.h"
+#include "DetectorConfig.h"
+#include "Parser.h"
+#include "Tokenizer.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+using TestSuite::check;
+
+namespace {
+    vector<uint32_t> lex(const vector<string_view> &lines) {
+        vector<uint32_t> tokens;
+        vector<uint32_t> tokenLines;
+        Tokenizer::lexTokens(Span<string_view>(lines), tokens, tokenLines);
+        return tokens;
+    }
+
+    // A block comment spanning lines inside a function body is dropped, lines starting with '*' included
+    void testMultiLineBlockComment() {
+        vector<string_view> withComment = {
+                "int sum(int count) {",
+                "    int total = 0;",
+                "    /* add up the numbers",
+                "     * below count",
+                "     */",
+                "    for (int i = 0; i < count; i++) { total += i; }",
+                "    return total;",
+                "}"
+        };
+        vector<string_view> withoutComment = {
+                "int sum(int count) {",
+                "    int total = 0;",
+                "    for (int i = 0; i < count; i++) { total += i; }",
+                "    return total;",
+                "}"
+        };
+        check(lex(withComment) == lex(withoutComment), "multi-line block comment is not lexed");
+
+        // Same through the parser and the detector, which lex the function's source lines
+        vector<string_view> file(withComment);
+        file.insert(file.end(), withoutComment.begin(), withoutComment.end());
+        Parser parser(file);
+        vector<pair<size_t, size_t>> lineRanges;
+        parser.forEachFunction([&lineRanges](size_t firstLineNumber, size_t lastLineNumber) {
+            lineRanges.emplace_back(firstLineNumber, lastLineNumber);
+        });
+        check(lineRanges.size() == 2, "both functions are found");
+
+        DetectorConfig config;
+        config.groupExactClones = true;
+        CodeSmellDetector detector(file, config);
+        check(detector.getFunctionTokens(0).size() == lex(withoutComment).size(),
+              "detector lexes the commented function without the comment");
+        check(detector.getCloneGroupOccurrences().size() == 1,
+              "functions differing in a block comment are exact clones");
+    }
+
+    // A line that only closes a comment leaves the tokens after it alone
+    void testCodeAfterCommentEnd() {
+        vector<string_view> lines = {
+                "/* start",
+                "   end */ return x;"
+        };
+        check(lex(lines) == lex({"return x;"}), "code after the end of a block comment is lexed");
+    }
+}
+
+void TestSuite::runTokenizerTests() {
+    testMultiLineBlockComment();
+    testCodeAfterCommentEnd();
+}
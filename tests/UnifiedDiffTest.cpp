@@ -0,0 +1,80 @@
+//
+// Created by Francis Kogge on 10/17/2026.
+//
+
+#include "TestSuite.h"
+#include "LineRange.h"
+#include "UnifiedDiff.h"
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using TestSuite::check;
+
+namespace {
+    typedef vector<pair<size_t, size_t>> Ranges; // First and last line of every changed range
+
+    Ranges changedLines(const string &diffText, const string &filename) {
+        istringstream in(diffText);
+        UnifiedDiff diff(in);
+        Ranges ranges;
+        for (const LineRange &range : diff.getChangedLines(filename)) {
+            ranges.emplace_back(range.firstLineNumber, range.lastLineNumber);
+        }
+        return ranges;
+    }
+
+    // A length of 1 is left out of the hunk header, on either side
+    void testOmittedHunkLengths() {
+        string replaced = "--- a/f.cpp\n"
+                          "+++ b/f.cpp\n"
+                          "@@ -1 +1 @@\n"
+                          "-int a;\n"
+                          "+int b;\n";
+        check(changedLines(replaced, "f.cpp") == Ranges({{1, 1}}), "\"@@ -1 +1 @@\" changes line 1");
+
+        string removed = "--- a/f.cpp\n"
+                         "+++ b/f.cpp\n"
+                         "@@ -3,2 +3 @@\n"
+                         " int a;\n"
+                         "-int b;\n"
+                         "@@ -9 +8,2 @@\n"
+                         " int c;\n"
+                         "+int d;\n";
+        check(changedLines(removed, "f.cpp") == Ranges({{4, 4}, {9, 9}}),
+              "a removal marks the line after it, an addition marks itself");
+
+        string created = "--- /dev/null\n"
+                         "+++ b/g.cpp\n"
+                         "@@ -0,0 +1 @@\n"
+                         "+int e;\n";
+        check(changedLines(created, "g.cpp") == Ranges({{1, 1}}), "\"@@ -0,0 +1 @@\" adds line 1");
+    }
+
+    // "\ No newline at end of file" follows a line without being one, inside a hunk or after its last line
+    void testNoNewlineMarker() {
+        string diffText = "--- a/f.cpp\n"
+                          "+++ b/f.cpp\n"
+                          "@@ -1,2 +1,3 @@\n"
+                          " int a;\n"
+                          "-int b;\n"
+                          "\\ No newline at end of file\n"
+                          "+int c;\n"
+                          "+int d;\n"
+                          "\\ No newline at end of file\n"
+                          "--- a/g.cpp\n"
+                          "+++ b/g.cpp\n"
+                          "@@ -4 +4,2 @@\n"
+                          " int d;\n"
+                          "+int e;\n";
+        check(changedLines(diffText, "f.cpp") == Ranges({{2, 3}}), "the marker does not shift the lines after it");
+        check(changedLines(diffText, "g.cpp") == Ranges({{5, 5}}), "the file after the marker is read");
+    }
+}
+
+void TestSuite::runUnifiedDiffTests() {
+    testOmittedHunkLengths();
+    testNoNewlineMarker();
+}